@@ -0,0 +1,240 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+
+#include <cudf/version.hh>
+#include <cudf/parser.hh>
+#include <cudf/program.hh>
+#include <clingo.hh>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "criteria.hh"
+#include "options.hh"
+
+#define CUDF_EXECUTABLE "aspcud-clingo"
+#define CUDF_USAGE "[option]... [cudfin] [cudfout] [criteria]"
+
+//////////////////// ClingoProgram ////////////////////////////// {{{1
+
+// Passes a ground program to the backend of clingo.
+//
+// The atoms of the ground program are mapped to fresh atoms of the backend
+// and shown strings become symbolic atoms.
+class ClingoProgram : public GroundProgram {
+public:
+    explicit ClingoProgram(Clingo::Backend &backend)
+        : backend_(backend) { }
+
+    void rule(AtomVec const &head, LitVec const &body, bool choice = false) {
+        std::vector<Clingo::atom_t> atoms;
+        for (Atom atom : head) { atoms.emplace_back(map_(atom)); }
+        auto lits = map_(body);
+        backend_.rule(choice, atoms, lits);
+        ++rules_;
+    }
+    void minimize(int64_t priority, WeightLitVec const &lits) {
+        std::vector<Clingo::WeightedLiteral> wlits;
+        for (auto &lit : lits) { wlits.emplace_back(map_(lit.first), weight_(lit.second)); }
+        backend_.minimize(weight_(priority), wlits);
+    }
+    void output(std::string const &str, LitVec const &cond) {
+        Clingo::atom_t atom = backend_.add_atom(Clingo::parse_term(str.c_str()));
+        auto lits = map_(cond);
+        backend_.rule(false, {atom}, lits);
+    }
+    void end() { }
+
+private:
+    Clingo::atom_t map_(Atom atom) {
+        while (atoms_.size() <= atom) { atoms_.emplace_back(atoms_.empty() ? 0 : backend_.add_atom()); }
+        return atoms_[atom];
+    }
+    Clingo::literal_t map_(Literal lit) {
+        return lit > 0 ? map_(static_cast<Atom>(lit)) : -static_cast<Clingo::literal_t>(map_(static_cast<Atom>(-lit)));
+    }
+    std::vector<Clingo::literal_t> map_(LitVec const &lits) {
+        std::vector<Clingo::literal_t> ret;
+        for (Literal lit : lits) { ret.emplace_back(map_(lit)); }
+        return ret;
+    }
+    static Clingo::weight_t weight_(int64_t weight) {
+        if (weight < std::numeric_limits<Clingo::weight_t>::min() || weight > std::numeric_limits<Clingo::weight_t>::max()) {
+            throw std::runtime_error("weight out of range of the solver");
+        }
+        return static_cast<Clingo::weight_t>(weight);
+    }
+
+private:
+    Clingo::Backend &backend_;
+    // backend atoms indexed by the atoms of the ground program
+    std::vector<Clingo::atom_t> atoms_;
+};
+
+//////////////////// main /////////////////////////////////////// {{{1
+
+void printUsage(Options &a) {
+    std::cout << "Usage: " << CUDF_EXECUTABLE << " " << CUDF_USAGE << "\n";
+    std::cout << a.description() <<
+        "\n"
+        "The optimization criterion can be passed as third argument or via option\n"
+        "--criterion. To get a list of supported criteria, call:\n"
+        "  cudf2lp --help\n"
+        "\n"
+        "If argument cudfout is not given, the solution is printed to stdout. If\n"
+        "argument cudfin is not given, input is read from stdin.\n";
+}
+
+void printVersion() {
+    std::cout << CUDF_EXECUTABLE << " version " << CUDF_VERSION << "\n";
+    std::cout << "clingo version " << CLINGO_VERSION << "\n\n";
+    std::cout << "License: The MIT License <https://opensource.org/licenses/MIT>" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        std::string criterion = "paranoid";
+        std::vector<std::string> inputs, encodings;
+        std::vector<std::string> solver_args;
+        bool help = false, version = false;
+        unsigned verbosity = 0;
+        Options options{"positional", 0, 79, true};
+        options.group("Aspcud Options");
+        options.add(inputs, "positional", "positional arguments", "arg", 3, 0, true);
+        options.add(criterion, "c,criterion", "optimization criterion");
+        options.add(solver_args, "s,solver-option", "append argument for solver", "--opt-strategy=5", "arg", 0);
+        options.add(encodings, "e,encoding", "ground encoding instead of passing the ground program\n"
+            "  of specification.lp to the solver", "enc", 0);
+
+        options.group("Basic Options", ":", 21);
+        options.add(help, "h,help", "print help information");
+        options.add(version, "v,version", "print version information");
+        options.add(verbosity, "V,verbosity", "set verbosity level", "n", 1);
+
+        options.parse(argc, argv);
+
+        if (help) {
+            printUsage(options);
+            return EXIT_SUCCESS;
+        }
+        if (version) {
+            printVersion();
+            return EXIT_SUCCESS;
+        }
+
+        if (inputs.size() == 0) { inputs.emplace_back("-"); }
+        if (inputs.size() == 1) { inputs.emplace_back("-"); }
+        if (inputs.size() == 2) { inputs.emplace_back(std::move(criterion)); }
+        else if (options.assigned("criterion")) {
+            throw OptionsException("multiple values for criteria");
+        }
+        if (solver_args.empty()) { solver_args.emplace_back("--opt-strategy=5"); }
+        Criteria::CritVec criteria;
+        option_from_string(inputs[2].c_str(), criteria, 0);
+
+        // preprocess
+        DependencyOptions opts;
+        opts.verbose = verbosity > 0;
+        opts.threads = std::max(1u, std::thread::hardware_concurrency());
+        Dependency d(criteria, opts);
+        Parser p(d);
+        if (inputs[0] == "-") { p.parse(std::cin); }
+        else {
+            std::ifstream in(inputs[0].c_str());
+            if (!in) { throw std::runtime_error("could not open file: " + inputs[0]); }
+            p.parse(in);
+        }
+        d.closure();
+        d.conflicts();
+        d.symmetries();
+
+        // pass the problem to the solver without intermediate files
+        std::vector<char const *> args;
+        for (auto &arg : solver_args) { args.emplace_back(arg.c_str()); }
+        Clingo::Control ctl{args};
+        if (encodings.empty()) {
+            ctl.with_backend([&](Clingo::Backend &backend) {
+                ClingoProgram prg(backend);
+                d.dumpProgram(prg);
+            });
+        }
+        else {
+            std::ostringstream facts;
+            d.dumpAsFacts(facts);
+            ctl.add("base", {}, facts.str().c_str());
+            for (auto &encoding : encodings) { ctl.load(encoding.c_str()); }
+        }
+        ctl.ground({{"base", {}}});
+
+        // the last model of the optimization is optimal or the best found
+        std::vector<Clingo::Symbol> solution;
+        bool solution_found = false;
+        for (auto &model : ctl.solve()) {
+            solution = model.symbols();
+            solution_found = true;
+            if (verbosity >= 1) {
+                std::cerr << "Optimization:";
+                for (auto cost : model.cost()) { std::cerr << " " << cost; }
+                std::cerr << std::endl;
+            }
+        }
+
+        // write the solution
+        std::ofstream out_file;
+        std::ostream &out = inputs[1] == "-" ? std::cout : out_file;
+        if (inputs[1] != "-") {
+            out_file.open(inputs[1], std::ios_base::out | std::ios_base::trunc);
+            if (!out_file) { throw std::runtime_error("could not open file: " + inputs[1]); }
+        }
+        if (solution_found) {
+            for (auto &sym : solution) {
+                if (!sym.match("in", 2)) { continue; }
+                auto args = sym.arguments();
+                out << "package: " << (args[0].type() == Clingo::SymbolType::String ? args[0].string() : args[0].to_string());
+                out << "\nversion: " << args[1];
+                out << "\ninstalled: true\n\n";
+            }
+        }
+        else {
+            out << "FAIL\n";
+        }
+        out.flush();
+        if (!out) { throw std::runtime_error("could not write solution"); }
+        return EXIT_SUCCESS;
+    }
+    catch (OptionsException const &e) {
+        std::cerr << "ERROR: " << e.what() << "\n";
+        std::cerr << "INFO : " << "try '--help' for usage information" << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch(const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
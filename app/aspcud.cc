@@ -42,15 +42,23 @@
 #endif
 #include <string>
 #include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <cstdio>
 #include <cstdlib>
+#include <cstdint>
 #include <cerrno>
 #include <cstring>
 #include <csignal>
 #include <cassert>
 #include <iterator>
+#include <chrono>
+#include <iomanip>
 #include <fcntl.h>
 #if defined(__APPLE__)
 #   include <mach-o/dyld.h>
@@ -72,6 +80,10 @@
 #ifndef ASPCUD_CLASP_BIN
 #define ASPCUD_CLASP_BIN "clasp"
 #endif
+// seconds the stages get to terminate after the time limit
+#ifndef ASPCUD_GRACE_PERIOD
+#define ASPCUD_GRACE_PERIOD 2
+#endif
 
 //////////////////// aspcud /////////////////////////// {{{1
 
@@ -85,12 +97,21 @@ private:
 
     std::string cudf2lp_out_;
     std::string cudf2lp_err_;
+    std::string cudf2lp_sym_;
     std::string gringo_out_;
     std::string gringo_err_;
     std::string clasp_out_;
     std::string clasp_err_;
 
     bool debug_ = false;
+    bool symbols_ = false;
+    // show only the changes to the installed packages
+    bool changes_ = false;
+    // print only the changed packages
+    bool diff_ = false;
+    std::string cudf2lp_inst_;
+    // output format of the preprocessor
+    std::string format_ = "lp";
     int verbosity_ = 0;
 
 #ifdef _WIN32
@@ -99,9 +120,36 @@ private:
     unsigned long interrupted_pid_ = 0;
 #else
     pid_t pid_             = 0;
-    pid_t current_pid_     = 0;
     pid_t interrupted_pid_ = 0;
+    // the running stages of the pipeline (or 0)
+    pid_t current_pids_[3] = {0, 0, 0};
 #endif
+    // connect the preprocessor, grounder, and solver through pipes
+    bool pipe_ = false;
+    // wall-clock budget in seconds (0 = unlimited)
+    unsigned time_limit_ = 0;
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    // set when the time limit is reached and when the grace period is over
+    volatile sig_atomic_t timed_out_ = 0;
+    volatile sig_atomic_t killed_ = 0;
+    // file descriptor or file receiving each improved solution
+    std::string stream_;
+    int stream_fd_ = -1;
+    // replace the output file with each improved solution
+    bool replace_ = false;
+    std::string output_;
+    // state of the solutions reported while the solver runs
+    bool progress_next_ = false;
+    bool progress_pending_ = false;
+    unsigned progress_answers_ = 0;
+    std::string progress_solution_;
+    // priorities of the criteria and scales of their weights
+    bool objective_read_ = false;
+    std::vector<int64_t> objective_levels_;
+    std::map<int64_t, int64_t> objective_scales_;
+    // names of the integers the preprocessor wrote instead of package names
+    bool symbols_read_ = false;
+    std::vector<std::string> symbols_names_;
 
 public:
     static Aspcud *app() {
@@ -155,6 +203,24 @@ int run(int argc, char *argv[]) {
     options.add(clasp_bin_, "S,solver", "path to solver", "path", 1);
     options.add(gringo_bin_, "G,grounder", "path to grounder", "path", 1);
     options.add(cudf2lp_bin_, "P,preprocessor", "path to preprocessor", "path", 1);
+    options.add(symbols_, "symbols", "pass package names as integers to grounder");
+    options.add(changes_, "changes", "let the solver show only changes to the installed packages");
+    options.add(diff_, "diff", "print only the changed packages (implies --changes)");
+    options.add(time_limit_, "time-limit", "write the best solution found after n seconds\n"
+        "  (0 = no limit)", "n", 1);
+    options.add(stream_, "stream", "write each improved solution to a file descriptor\n"
+        "  or file (e.g., a FIFO) as soon as it is found", "fd|file", 1);
+    options.add(replace_, "replace", "atomically replace cudfout with each improved\n"
+        "  solution as soon as it is found");
+    options.add(pipe_, "pipe", "run preprocessor, grounder, and solver concurrently\n"
+        "  connected through pipes (requires format lp or aspif)");
+    options.add(format_, "format", "select the output format of the preprocessor\n"
+        "  Accepted values: lp, aspif, wcnf, opb\n"
+        "    lp   : facts grounded by the grounder\n"
+        "    aspif: ground program of encoding specification.lp\n"
+        "    wcnf : weighted partial MaxSAT problem of the program\n"
+        "    opb  : pseudo-Boolean problem of the program\n"
+        "  all formats but lp skip the grounder", "lp", "fmt");
 
     options.group("Basic Options", ":", 21);
     options.add(help, "h,help", "print help information");
@@ -186,12 +252,42 @@ int run(int argc, char *argv[]) {
 
     cudf2lp_args[0] = cudf2lp_bin_;
 
+    if (format_ != "lp" && format_ != "aspif" && format_ != "wcnf" && format_ != "opb") {
+        throw OptionsException("invalid output format");
+    }
+    bool ground = format_ == "lp";
+    // MaxSAT and pseudo-Boolean solvers only get the given options
+    bool competition = format_ == "wcnf" || format_ == "opb";
+
     clasp_args[0] = clasp_bin_;
-    if (clasp_args.size() == 1) {
-        clasp_args.insert(clasp_args.end(), clasp_args_default.begin(), clasp_args_default.end());
+    if (!competition) {
+        if (clasp_args.size() == 1) {
+            clasp_args.insert(clasp_args.end(), clasp_args_default.begin(), clasp_args_default.end());
+        }
+        // with a time limit each model is printed so that the last one is
+        // available even if the solver has to be killed; each model and its
+        // costs are also needed to report improved solutions while solving
+        clasp_args.emplace_back(time_limit_ > 0 || !stream_.empty() || replace_ ? "-q0" : "-q1,2");
+        clasp_args.emplace_back("--stats=2");
+    }
+
+    if (!ground && (!gringo_encodings.empty() || gringo_args.size() > 1)) {
+        throw OptionsException("options --encoding and --grounder-option require format lp");
     }
-    clasp_args.emplace_back("-q1,2");
-    clasp_args.emplace_back("--stats=2");
+    // the preprocessor writes the names of packages in the ground program
+    if (!ground) { symbols_ = false; }
+    if (pipe_ && competition) {
+        throw OptionsException("option --pipe requires format lp or aspif");
+    }
+    if ((!stream_.empty() || replace_) && competition) {
+        throw OptionsException("options --stream and --replace require format lp or aspif");
+    }
+#ifdef _WIN32
+    if (pipe_ || !stream_.empty() || replace_) {
+        throw OptionsException("options --pipe, --stream, and --replace are not supported on this platform");
+    }
+#endif
+    if (diff_) { changes_ = true; }
 
     if (gringo_encodings.empty()) {
         gringo_encodings.emplace_back(encoding_);
@@ -208,14 +304,37 @@ int run(int argc, char *argv[]) {
     else if (options.assigned("criteria")) {
         throw OptionsException("multiple values for criteria");
     }
+    if (replace_ && inputs[1] == "-") {
+        throw OptionsException("option --replace requires argument cudfout");
+    }
+    output_ = inputs[1];
 
     setmain_();
     if (atexit(&atexit_) != 0) {
         throw std::runtime_error("could not set exithandler");
     }
+#ifndef _WIN32
+    if (time_limit_ > 0) {
+        // reading the output of the solver is interrupted after the grace
+        // period even if some process keeps the pipe open
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_handler = &timeout_;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGALRM, &action, nullptr);
+        alarm(time_limit_);
+    }
+    if (!stream_.empty()) { open_stream_(); }
+#endif
+    std::function<void(std::string const &)> progress;
+    if (stream_fd_ != -1 || replace_) {
+        progress = [this](std::string const &line) { progress_(line); };
+    }
 
     cudf2lp_out_ = tempfile_("cudf2lp.outXXXXXX");
     cudf2lp_err_ = tempfile_("cudf2lp.errXXXXXX");
+    if (symbols_) { cudf2lp_sym_ = tempfile_("cudf2lp.symXXXXXX"); }
+    if (changes_) { cudf2lp_inst_ = tempfile_("cudf2lp.instXXXXXX"); }
     gringo_out_ = tempfile_("gringo.outXXXXXX");
     gringo_err_ = tempfile_("gringo.errXXXXXX");
     clasp_out_ = tempfile_("clasp.outXXXXXX");
@@ -225,38 +344,98 @@ int run(int argc, char *argv[]) {
     cudf2lp_args.emplace_back(inputs[0]);
     cudf2lp_args.emplace_back("-c");
     cudf2lp_args.emplace_back(inputs[2]);
-    int cudf2lp_status = exec_(cudf2lp_args, cudf2lp_out_, cudf2lp_err_);
-    aspcud_ecat(cudf2lp_err_);
-    if (cudf2lp_status != 0) {
-        throw std::runtime_error("preprocessor returned with non-zero exit status");
+    if (!ground) {
+        cudf2lp_args.emplace_back("--output");
+        cudf2lp_args.emplace_back(format_);
     }
-
-    // run gringo
-    gringo_args.emplace_back("-f");
-    gringo_args.emplace_back(cudf2lp_out_);
-    int gringo_status = exec_(gringo_args, gringo_out_, gringo_err_);
-    aspcud_ecat(gringo_err_);
-    if (gringo_status != 0) {
-        throw std::runtime_error("grounder returned with non-zero exit status");
+    if (symbols_) {
+        cudf2lp_args.emplace_back("--symbols");
+        cudf2lp_args.emplace_back(cudf2lp_sym_);
+    }
+    if (changes_) {
+        cudf2lp_args.emplace_back("--installed");
+        cudf2lp_args.emplace_back(cudf2lp_inst_);
+        if (ground) {
+            gringo_args.emplace_back("-c");
+            gringo_args.emplace_back("outPutIn=2");
+        }
+        else { cudf2lp_args.emplace_back("--changes"); }
+    }
+    // whether preprocessor and grounder finished before the time limit
+    bool complete = true;
+#ifndef _WIN32
+    if (pipe_) {
+        // the grounder and solver read from their standard input; the output
+        // of the preprocessor is only copied to its file for printing the
+        // objective and debugging
+        std::vector<Stage> stages;
+        stages.push_back({cudf2lp_args, cudf2lp_err_, verbosity_ >= 1 || debug_ || progress ? cudf2lp_out_ : ""});
+        if (ground) {
+            gringo_args.emplace_back("-f");
+            gringo_args.emplace_back("-");
+            stages.push_back({gringo_args, gringo_err_, debug_ ? gringo_out_ : ""});
+        }
+        solver_time_limit_(clasp_args, competition);
+        clasp_args.emplace_back("-f");
+        clasp_args.emplace_back("-");
+        stages.push_back({clasp_args, clasp_err_, ""});
+        auto status = pipeline_(stages, clasp_out_, progress);
+        aspcud_ecat(cudf2lp_err_);
+        complete = check_status_(status[0], "preprocessor");
+        if (ground) {
+            aspcud_ecat(gringo_err_);
+            complete = check_status_(status[1], "grounder") && complete;
+        }
+        aspcud_ecat(clasp_err_);
     }
+    else
+#endif
+    {
+        int cudf2lp_status = exec_(cudf2lp_args, cudf2lp_out_, cudf2lp_err_);
+        aspcud_ecat(cudf2lp_err_);
+        complete = check_status_(cudf2lp_status, "preprocessor");
 
-    // run clasp
-    clasp_args.emplace_back("-f");
-    clasp_args.emplace_back(gringo_out_);
-    int clasp_status = exec_(clasp_args, clasp_out_, clasp_err_);
-    // TODO: is it possible to do something with the exit status of clasp???
-    (void)clasp_status;
-    aspcud_ecat(clasp_err_);
+        // run gringo
+        if (ground && complete) {
+            gringo_args.emplace_back("-f");
+            gringo_args.emplace_back(cudf2lp_out_);
+            int gringo_status = exec_(gringo_args, gringo_out_, gringo_err_);
+            aspcud_ecat(gringo_err_);
+            complete = check_status_(gringo_status, "grounder");
+        }
+
+        // run clasp
+        if (complete) {
+            solver_time_limit_(clasp_args, competition);
+            if (!competition) { clasp_args.emplace_back("-f"); }
+            clasp_args.emplace_back(ground ? gringo_out_ : cudf2lp_out_);
+            int clasp_status = exec_(clasp_args, clasp_out_, clasp_err_, progress);
+            // TODO: is it possible to do something with the exit status of clasp???
+            (void)clasp_status;
+            aspcud_ecat(clasp_err_);
+        }
+    }
+#ifndef _WIN32
+    alarm(0);
+#endif
+    if (complete) { progress_flush_(""); }
 
     // find answer set
     std::string solution;
+    std::string optimization;
     bool solution_found = false;
+    // value lines and status of solvers following the competition formats
+    std::vector<std::string> values;
+    bool unsatisfiable = false;
+    bool optimum = false;
     std::ifstream fclasp_out;
     fclasp_out.exceptions(std::ifstream::failbit | std::ifstream::badbit);
     try {
         fclasp_out.open(clasp_out_);
         int next = 0;
-        for (std::string line; std::getline(fclasp_out, line); ) {
+        // the solver only has the complete program if the previous stages
+        // finished
+        for (std::string line; complete && std::getline(fclasp_out, line); ) {
             if (verbosity_ >= 2) {
                 if (line.length() < 80) {
                     std::cerr << line << std::endl;
@@ -266,51 +445,70 @@ int run(int argc, char *argv[]) {
                     std::cerr << " ..." << std::endl;
                 }
             }
-            if (next == 1) {
-                solution = std::move(line);
-                solution_found = true;
+            if (competition) {
+                // only the values after the last improvement are kept
+                if (std::strncmp("o ", line.c_str(), 2) == 0) { values.clear(); }
+                else if (std::strncmp("v ", line.c_str(), 2) == 0) { values.emplace_back(line.substr(2)); }
+                else if (std::strncmp("s UNSATISFIABLE", line.c_str(), 15) == 0) { unsatisfiable = true; }
+                else if (std::strncmp("s OPTIMUM FOUND", line.c_str(), 15) == 0) { optimum = true; }
+            }
+            else if (next == 1) {
+                // the last line is incomplete if the solver has been killed
+                if (!fclasp_out.eof()) {
+                    solution = std::move(line);
+                    solution_found = true;
+                }
                 next = 0;
             }
+            else if (std::strncmp("OPTIMUM FOUND", line.c_str(), 13) == 0) {
+                optimum = true;
+            }
             else if (std::strncmp("Answer:", line.c_str(), 7) == 0) {
                 next = 1;
             }
+            else if (std::strncmp("Optimization", line.c_str(), 12) == 0) {
+                optimization = std::move(line);
+            }
         }
     }
     catch (std::ios_base::failure const &e) {
         if (!fclasp_out.eof()) { throw e; }
     }
     fclasp_out.close();
+    if (competition && !unsatisfiable && !values.empty()) {
+        solution = shown_atoms_(values);
+        solution_found = true;
+    }
+    if (verbosity_ >= 1 && solution_found && !optimization.empty()) {
+        std::cerr << "objective:";
+        for (auto value : objective_(optimization)) { std::cerr << " " << value; }
+        std::cerr << std::endl;
+    }
+    if (timed_out_) {
+        std::cerr << "warning: time limit reached" << std::endl;
+    }
+    if ((verbosity_ >= 1 || time_limit_ > 0) && solution_found) {
+        std::cerr << "optimum: " << (optimum ? "proven" : "not proven") << std::endl;
+    }
+
+    if (stream_fd_ != -1) {
+        std::string done = !solution_found ? "FAIL" : optimum ? "optimum proven" : "optimum not proven";
+        write_stream_("# done: " + done + "\n");
+        close(stream_fd_);
+    }
 
     // rewrite the solution
+    if (replace_) {
+        replace_output_(output_, solution_found, solution);
+        return EXIT_SUCCESS;
+    }
     std::ofstream aspcud_out_file;
     aspcud_out_file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
     std::ostream &faspcud_out = inputs[1] == "-" ? std::cout : aspcud_out_file;
     auto old = faspcud_out.exceptions();
     faspcud_out.exceptions(std::ifstream::failbit | std::ifstream::badbit);
     if (inputs[1] != "-") { aspcud_out_file.open(inputs[1], std::ios_base::out | std::ios_base::trunc); }
-    if (solution_found) {
-        char const *it = solution.c_str();
-        while ((it = std::strstr(it, "in(\""))) {
-            it+= 4;
-            char const *comma = strchr(it, ',');
-            if (!comma) {
-                throw std::runtime_error("unexpected output");
-            }
-            char const *paren = strchr(comma, ')');
-            if (!paren) {
-                throw std::runtime_error("unexpected output");
-            }
-            faspcud_out << "package: ";
-            std::copy(it, comma-1, std::ostreambuf_iterator<char>(faspcud_out));
-            faspcud_out << "\nversion: ";
-            std::copy(comma+1, paren, std::ostreambuf_iterator<char>(faspcud_out));
-            faspcud_out << "\ninstalled: true\n\n";
-            it = paren + 1;
-        }
-    }
-    else {
-        faspcud_out << "FAIL\n";
-    }
+    write_solution_(faspcud_out, solution_found, solution);
     if (&faspcud_out == &aspcud_out_file) {
         aspcud_out_file.close();
     }
@@ -428,6 +626,39 @@ private:
 #endif
     }
 
+    // throws if a stage failed unless the time limit has been reached
+    bool check_status_(int status, char const *name) {
+        if (status == 0) { return true; }
+        if (timed_out_) { return false; }
+        throw std::runtime_error(std::string(name) + " returned with non-zero exit status");
+    }
+
+    // passes the remaining time to the solver leaving it a second to print
+    // its best model before it is interrupted
+    void solver_time_limit_(std::vector<std::string> &args, bool competition) {
+        if (time_limit_ == 0 || competition) { return; }
+        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start_).count();
+        long remaining = static_cast<long>(time_limit_) - elapsed - 1;
+        args.emplace_back("--time-limit=" + std::to_string(std::max(1L, remaining)));
+    }
+
+    static void timeout_(int) {
+#ifndef _WIN32
+        if (!app()->timed_out_) {
+            app()->timed_out_ = 1;
+            interrupt_(SIGTERM);
+            // give the solver some time to print its best model
+            alarm(ASPCUD_GRACE_PERIOD);
+        }
+        else {
+            app()->killed_ = 1;
+            for (pid_t pid : app()->current_pids_) {
+                if (pid > 0) { kill(pid, SIGKILL); }
+            }
+        }
+#endif
+    }
+
     static void interrupt_(int signal) {
 #ifdef _WIN32
         if (!app()->interrupted_) {
@@ -438,11 +669,15 @@ private:
         }
         app()->interrupted_ = 1;
 #else
-        if (app()->current_pid_ > 0) {
-            kill(app()->current_pid_, signal);
-            app()->interrupted_pid_ = app()->current_pid_;
+        bool running = false;
+        for (pid_t pid : app()->current_pids_) {
+            if (pid > 0) {
+                kill(pid, signal);
+                app()->interrupted_pid_ = pid;
+                running = true;
+            }
         }
-        else { app()->interrupted_pid_ = -1; }
+        if (!running) { app()->interrupted_pid_ = -1; }
 #endif
     }
 
@@ -478,7 +713,11 @@ private:
     }
 #endif
 
-    int exec_(std::vector<std::string> const &args, std::string const &out_path, std::string const &err_path) {
+    // the optional callback receives the lines of the output while the
+    // process runs
+    int exec_(std::vector<std::string> const &args, std::string const &out_path, std::string const &err_path, std::function<void(std::string const &)> const &lines = nullptr) {
+#ifdef _WIN32
+        (void)lines;
         if (verbosity_ >= 1) {
             std::cerr << "debug: starting process";
             for (auto &arg : args) {
@@ -486,7 +725,6 @@ private:
             }
             std::cerr << std::endl;
         }
-#ifdef _WIN32
         if (interrupted_) { return 1; }
         // file descriptors returned by open are inheritable
         // http://msdn.microsoft.com/en-us/library/z0kc8e3z.aspx
@@ -532,26 +770,154 @@ private:
         close(err_fd);
         return interrupted_ ? 1 : exitCode;
 #else
-        if (interrupted_pid_ != 0) { return 1; }
-        current_pid_ = fork();
-        if (current_pid_ == -1) {
-            throw std::runtime_error("could not fork " + args.front() + " (" + strerror(errno) + ")");
+        return pipeline_({{args, err_path, ""}}, out_path, lines).front();
+#endif
+    }
+
+#ifndef _WIN32
+    struct Stage {
+        std::vector<std::string> const &args;
+        std::string const &err_path;
+        // path of a file receiving a copy of the output (or empty)
+        std::string tee_path;
+    };
+
+    // runs the stages concurrently connecting the output of each stage to
+    // the input of the next one; the output of the last stage is written to
+    // out_path (passing its lines to the callback if given) and the exit
+    // status of each stage is returned
+    std::vector<int> pipeline_(std::vector<Stage> const &stages, std::string const &out_path, std::function<void(std::string const &)> const &lines = nullptr) {
+        std::vector<int> status(stages.size(), 1);
+        if (interrupted_pid_ != 0) { return status; }
+        assert(stages.size() <= sizeof(current_pids_) / sizeof(*current_pids_));
+        std::vector<pid_t> tees;
+        int in_fd = -1;
+        for (size_t i = 0; i < stages.size(); ++i) {
+            int fds[2];
+            if (i + 1 < stages.size() || lines) { pipe_fds_(fds); }
+            else {
+                fds[0] = -1;
+                fds[1] = open(out_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+                if (fds[1] == -1) {
+                    throw std::runtime_error("could not open " + out_path + " (" + strerror(errno) + ")");
+                }
+            }
+            current_pids_[i] = spawn_(stages[i].args, in_fd, fds[1], stages[i].err_path);
+            if (in_fd != -1) { close(in_fd); }
+            close(fds[1]);
+            in_fd = fds[0];
+            // NOTE: the child has been started and a signal handler might have been executed unnoticed
+            if (interrupted_pid_ < 0) {
+                kill(current_pids_[i], SIGTERM);
+                interrupted_pid_ = current_pids_[i];
+            }
+            if (in_fd != -1 && !stages[i].tee_path.empty()) {
+                pipe_fds_(fds);
+                tees.emplace_back(tee_(in_fd, fds[1], stages[i].tee_path));
+                close(in_fd);
+                close(fds[1]);
+                in_fd = fds[0];
+            }
+        }
+        if (lines) {
+            copy_lines_(in_fd, out_path, lines);
+            close(in_fd);
+        }
+        for (size_t i = 0; i < stages.size(); ++i) {
+            status[i] = wait_(current_pids_[i], stages[i].args.front());
+            current_pids_[i] = 0;
+        }
+        for (pid_t pid : tees) {
+            if (wait_(pid, "tee") != 0) { std::cerr << "warning: could not copy the output of a stage to a file" << std::endl; }
+        }
+        return status;
+    }
+
+    // copies in_fd to the file at out_path passing complete lines to the
+    // callback
+    void copy_lines_(int in_fd, std::string const &out_path, std::function<void(std::string const &)> const &lines) {
+        int out_fd = open(out_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        if (out_fd == -1) {
+            throw std::runtime_error("could not open " + out_path + " (" + strerror(errno) + ")");
+        }
+        std::string line;
+        char buf[65536];
+        while (true) {
+            ssize_t n = read(in_fd, buf, sizeof(buf));
+            if (n == -1 && errno == EINTR && !killed_) { continue; }
+            if (n <= 0) { break; }
+            if (!write_all_(out_fd, buf, n)) {
+                throw std::runtime_error("could not write " + out_path + " (" + strerror(errno) + ")");
+            }
+            for (char *it = buf, *ie = buf + n; it != ie; ) {
+                char *jt = std::find(it, ie, '\n');
+                line.append(it, jt);
+                if (jt == ie) { break; }
+                lines(line);
+                line.clear();
+                it = jt + 1;
+            }
+        }
+        close(out_fd);
+    }
+
+    static bool write_all_(int fd, char const *buf, size_t n) {
+        while (n > 0) {
+            ssize_t ret = write(fd, buf, n);
+            if (ret == -1) {
+                if (errno == EINTR) { continue; }
+                return false;
+            }
+            buf += ret;
+            n   -= ret;
         }
-        if (!current_pid_) {
-            auto mode = S_IRUSR | S_IWUSR;
-            int out_fd = open(out_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, mode);
-            if (out_fd == -1) {
-                throw std::runtime_error("could not open " + out_path + " (" + strerror(errno) + ")");
+        return true;
+    }
+
+    // a pipe whose file descriptors are closed when executing a program
+    void pipe_fds_(int fds[2]) {
+        if (pipe(fds) == -1) {
+            throw std::runtime_error("could not create pipe (" + std::string(strerror(errno)) + ")");
+        }
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    }
+
+    // reports an error of a forked child and terminates it without running
+    // the error handling and cleanup of the parent's copy of aspcud
+    [[noreturn]] static void child_error_(std::string const &msg) {
+        std::string line = "ERROR: " + msg + "\n";
+        write_all_(STDERR_FILENO, line.c_str(), line.size());
+        _exit(127);
+    }
+
+    // starts a process reading from in_fd (or the standard input if -1),
+    // writing to out_fd, and writing errors to err_path
+    pid_t spawn_(std::vector<std::string> const &args, int in_fd, int out_fd, std::string const &err_path) {
+        if (verbosity_ >= 1) {
+            std::cerr << "debug: starting process";
+            for (auto &arg : args) {
+                std::cerr << " " << arg;
             }
-            int err_fd = open(err_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, mode);
+            std::cerr << std::endl;
+        }
+        pid_t pid = fork();
+        if (pid == -1) {
+            throw std::runtime_error("could not fork " + args.front() + " (" + strerror(errno) + ")");
+        }
+        if (!pid) {
+            int err_fd = open(err_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
             if (err_fd == -1) {
-                throw std::runtime_error("could not open " + err_path + " (" + strerror(errno) + ")");
+                child_error_("could not open " + err_path + " (" + strerror(errno) + ")");
+            }
+            if (in_fd != -1 && dup2(in_fd, STDIN_FILENO) == -1) {
+                child_error_("could not duplicate stdin (" + std::string(strerror(errno)) + ")");
             }
             if (dup2(out_fd, STDOUT_FILENO) == -1) {
-                throw std::runtime_error("could not duplicate stdout (" + std::string(strerror(errno)) + ")");
+                child_error_("could not duplicate stdout (" + std::string(strerror(errno)) + ")");
             }
             if (dup2(err_fd, STDERR_FILENO) == -1) {
-                throw std::runtime_error("could not duplicate stderr (" + std::string(strerror(errno)) + ")");
+                child_error_("could not duplicate stderr (" + std::string(strerror(errno)) + ")");
             }
             std::vector<std::unique_ptr<char[]>> uargs;
             std::vector<char *> sargs;
@@ -561,33 +927,64 @@ private:
                 sargs.emplace_back(uargs.back().get());
             }
             sargs.emplace_back(nullptr);
+            signal(SIGPIPE, SIG_DFL);
             execvp(sargs[0], sargs.data());
-            throw std::runtime_error("executing " + args.front() + " failed (" + strerror(errno) + ")");
+            child_error_("executing " + args.front() + " failed (" + strerror(errno) + ")");
+        }
+        return pid;
+    }
+
+    // starts a process copying in_fd to out_fd and to the file at path
+    pid_t tee_(int in_fd, int out_fd, std::string const &path) {
+        pid_t pid = fork();
+        if (pid == -1) {
+            throw std::runtime_error("could not fork (" + std::string(strerror(errno)) + ")");
         }
-        // NOTE: the child has been started and a signal handler might have been executed unnoticed
-        if (interrupted_pid_ < 0) {
-            kill(current_pid_, SIGTERM);
-            interrupted_pid_ = current_pid_;
+        if (!pid) {
+            // the copy ends when the previous stage closes its output
+            signal(SIGTERM, SIG_IGN);
+            signal(SIGUSR1, SIG_IGN);
+            signal(SIGINT,  SIG_IGN);
+            int file_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+            char buf[65536];
+            while (true) {
+                ssize_t n = read(in_fd, buf, sizeof(buf));
+                if (n == -1 && errno == EINTR) { continue; }
+                if (n <= 0) { break; }
+                if (file_fd != -1 && !write_all_(file_fd, buf, n)) {
+                    close(file_fd);
+                    file_fd = -1;
+                }
+                if (!write_all_(out_fd, buf, n)) { _exit(EXIT_FAILURE); }
+            }
+            // a missing copy is reported but does not affect the next stage
+            _exit(file_fd != -1 && close(file_fd) == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
         }
+        return pid;
+    }
+
+    int wait_(pid_t pid, std::string const &name) {
         int status = 1;
         while (1) {
-            int ret = waitpid(current_pid_, &status, 0);
+            int ret = waitpid(pid, &status, 0);
             if (ret == -1) {
                 if (errno == EINTR) { continue; }
                 else {
-                    throw std::runtime_error("executing " + args.front() + " failed (" + strerror(errno) + ")");
+                    throw std::runtime_error("executing " + name + " failed (" + strerror(errno) + ")");
                 }
             }
             else { break; }
         }
         return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
-#endif
     }
+#endif
 
     static void atexit_() {
         if (!app()->debug_ && app()->ismain_()) {
             if (!app()->cudf2lp_out_.empty()) { unlink(app()->cudf2lp_out_.c_str()); }
             if (!app()->cudf2lp_err_.empty()) { unlink(app()->cudf2lp_err_.c_str()); }
+            if (!app()->cudf2lp_sym_.empty()) { unlink(app()->cudf2lp_sym_.c_str()); }
+            if (!app()->cudf2lp_inst_.empty()) { unlink(app()->cudf2lp_inst_.c_str()); }
             if (!app()->gringo_out_.empty())  { unlink(app()->gringo_out_.c_str()); }
             if (!app()->gringo_err_.empty())  { unlink(app()->gringo_err_.c_str()); }
             if (!app()->clasp_out_.empty())   { unlink(app()->clasp_out_.c_str()); }
@@ -625,6 +1022,252 @@ private:
         }
     }
 
+    // the optimization values of the solver multiplied with the divisors the
+    // preprocessor applied to the weights of sum criteria
+    std::vector<int64_t> objective_(std::string const &optimization) {
+        if (!objective_read_) {
+            std::ifstream in{cudf2lp_out_};
+            for (std::string line; std::getline(in, line); ) {
+                if (std::strncmp("criterion(", line.c_str(), 10) == 0) {
+                    objective_levels_.emplace_back(std::strtoll(line.c_str() + line.rfind(',') + 1, nullptr, 10));
+                }
+                else if (std::strncmp("scale(", line.c_str(), 6) == 0) {
+                    char *end = nullptr;
+                    int64_t level = std::strtoll(line.c_str() + 6, &end, 10);
+                    objective_scales_[level] = std::strtoll(end + 1, nullptr, 10);
+                }
+            }
+            // the solver prints the values by decreasing priority
+            auto &levels = objective_levels_;
+            std::sort(levels.begin(), levels.end(), std::greater<int64_t>());
+            levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+            objective_read_ = true;
+        }
+        std::vector<int64_t> ret;
+        std::istringstream values{optimization.substr(optimization.find(':') + 1)};
+        size_t index = 0;
+        for (int64_t value; values >> value; ++index) {
+            if (index < objective_levels_.size()) {
+                auto it = objective_scales_.find(objective_levels_[index]);
+                if (it != objective_scales_.end()) { value *= it->second; }
+            }
+            ret.emplace_back(value);
+        }
+        return ret;
+    }
+
+    // writes the packages of a solution in CUDF format (or FAIL if there is
+    // none)
+    void write_solution_(std::ostream &out, bool solution_found, std::string const &solution) {
+        if (!solution_found) {
+            out << "FAIL\n";
+            return;
+        }
+        auto write = [&](std::string const &name, std::string const &version, bool installed) {
+            out << "package: " << name;
+            out << "\nversion: " << version;
+            out << "\ninstalled: " << (installed ? "true" : "false") << "\n\n";
+        };
+        if (!changes_) {
+            shown_packages_(solution, write);
+        }
+        else {
+            // the solver only shows the changes, so they are merged with the
+            // installed packages written by cudf2lp; installed packages that
+            // are no candidates after the closure are treated as removed
+            std::set<std::pair<std::string, std::string>> removed;
+            std::vector<std::pair<std::string, std::string>> added;
+            shown_packages_(solution, [&](std::string const &name, std::string const &version, bool installed) {
+                if (installed) { added.emplace_back(name, version); }
+                else           { removed.emplace(name, version); }
+            });
+            std::ifstream in{cudf2lp_inst_};
+            bool candidate;
+            for (std::string name, version; in >> name >> version >> candidate; ) {
+                bool keep = candidate && removed.find({name, version}) == removed.end();
+                if (!diff_)     { if (keep) { write(name, version, true); } }
+                else if (!keep) { write(name, version, false); }
+            }
+            for (auto &pkg : added) { write(pkg.first, pkg.second, true); }
+        }
+    }
+
+    // writes the solution to a temporary file next to path and renames it
+    void replace_output_(std::string const &path, bool solution_found, std::string const &solution) {
+        std::string temp = path + ".tmp";
+        std::ofstream out;
+        out.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        out.open(temp, std::ios_base::out | std::ios_base::trunc);
+        write_solution_(out, solution_found, solution);
+        out.close();
+        if (std::rename(temp.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("could not replace " + path + " (" + strerror(errno) + ")");
+        }
+    }
+
+    // tracks the answers of the solver line by line
+    void progress_(std::string const &line) {
+        if (progress_next_) {
+            progress_solution_ = line;
+            progress_pending_ = true;
+            progress_next_ = false;
+        }
+        else if (std::strncmp("Answer:", line.c_str(), 7) == 0) {
+            progress_flush_("");
+            progress_next_ = true;
+        }
+        else if (std::strncmp("Optimization", line.c_str(), 12) == 0) {
+            progress_flush_(line);
+        }
+    }
+
+    // reports the last answer together with its objective values and the
+    // elapsed time
+    void progress_flush_(std::string const &optimization) {
+        if (!progress_pending_) { return; }
+        progress_pending_ = false;
+        try {
+            if (stream_fd_ != -1) {
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+                std::ostringstream out;
+                out << "# answer: " << ++progress_answers_ << "\n";
+                if (!optimization.empty()) {
+                    out << "# objective:";
+                    for (auto value : objective_(optimization)) { out << " " << value; }
+                    out << "\n";
+                }
+                out << "# time: " << std::fixed << std::setprecision(3) << elapsed.count() << "\n";
+                write_solution_(out, true, progress_solution_);
+                write_stream_(out.str());
+            }
+            if (replace_) { replace_output_(output_, true, progress_solution_); }
+        }
+        catch (std::exception const &e) {
+            std::cerr << "warning: could not report solution (" << e.what() << ")" << std::endl;
+        }
+    }
+
+#ifndef _WIN32
+    // opens the file descriptor or file given by option --stream
+    void open_stream_() {
+        if (stream_.find_first_not_of("0123456789") == std::string::npos) {
+            stream_fd_ = std::atoi(stream_.c_str());
+            if (fcntl(stream_fd_, F_GETFD) == -1) {
+                throw std::runtime_error("invalid file descriptor " + stream_);
+            }
+        }
+        else {
+            stream_fd_ = open(stream_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+            if (stream_fd_ == -1) {
+                throw std::runtime_error("could not open " + stream_ + " (" + strerror(errno) + ")");
+            }
+        }
+        // the solver must not keep a reader of a FIFO waiting
+        fcntl(stream_fd_, F_SETFD, FD_CLOEXEC);
+        // a reader closing the stream must not terminate aspcud
+        signal(SIGPIPE, SIG_IGN);
+    }
+#endif
+
+    void write_stream_(std::string const &str) {
+#ifndef _WIN32
+        if (stream_fd_ != -1 && !write_all_(stream_fd_, str.c_str(), str.size())) {
+            std::cerr << "warning: could not write to " << stream_ << " (" << strerror(errno) << ")" << std::endl;
+            close(stream_fd_);
+            stream_fd_ = -1;
+        }
+#else
+        (void)str;
+#endif
+    }
+
+    // the shown atoms of the variables assigned true by the value lines of a
+    // MaxSAT or pseudo-Boolean solver; variables are given as (negated)
+    // integers optionally prefixed with x or as a string of zeros and ones
+    std::string shown_atoms_(std::vector<std::string> const &values) {
+        std::vector<bool> assignment;
+        auto assign = [&](size_t var) {
+            if (var >= assignment.size()) { assignment.resize(var + 1, false); }
+            assignment[var] = true;
+        };
+        for (auto &line : values) {
+            std::istringstream iss{line};
+            for (std::string value; iss >> value; ) {
+                if (value.size() > 1 && value.find_first_not_of("01") == std::string::npos) {
+                    for (size_t i = 0; i < value.size(); ++i) {
+                        if (value[i] == '1') { assign(i + 1); }
+                    }
+                }
+                else if (value[0] != '-') {
+                    size_t var = std::strtoul(value.c_str() + (value[0] == 'x' ? 1 : 0), nullptr, 10);
+                    if (var > 0) { assign(var); }
+                }
+            }
+        }
+        std::string solution;
+        std::ifstream in{cudf2lp_out_};
+        for (std::string line; std::getline(in, line); ) {
+            // comments of form "c show <var> <atom>" or "* show <var> <atom>"
+            if (line.size() < 7 || line.compare(1, 6, " show ") != 0) { continue; }
+            char *end = nullptr;
+            size_t var = std::strtoul(line.c_str() + 7, &end, 10);
+            if (var < assignment.size() && assignment[var]) {
+                solution += end;
+            }
+        }
+        return solution;
+    }
+
+    // calls write(name, version, installed) for the atoms in(P,V) and, if
+    // only changes are shown, out(P,V) in the solution
+    template <class F>
+    void shown_packages_(std::string const &solution, F write) {
+        std::istringstream iss{solution};
+        for (std::string atom; iss >> atom; ) {
+            bool installed = atom.compare(0, 3, "in(") == 0;
+            if (!installed && atom.compare(0, 4, "out(") != 0) { continue; }
+            size_t begin = atom.find('(') + 1, comma, paren = atom.rfind(')');
+            std::string name;
+            if (symbols_) {
+                auto const &names = read_symbols_();
+                char *end = nullptr;
+                unsigned long id = std::strtoul(atom.c_str() + begin, &end, 10);
+                comma = end - atom.c_str();
+                if (comma == begin || atom[comma] != ',' || id >= names.size() || names[id].empty()) {
+                    throw std::runtime_error("unexpected output");
+                }
+                name = names[id];
+            }
+            else {
+                comma = atom.find("\",", begin);
+                if (atom[begin] != '"' || comma == std::string::npos) {
+                    throw std::runtime_error("unexpected output");
+                }
+                name = atom.substr(begin + 1, comma - begin - 1);
+                ++comma;
+            }
+            if (paren == std::string::npos || paren < comma) {
+                throw std::runtime_error("unexpected output");
+            }
+            write(name, atom.substr(comma + 1, paren - comma - 1), installed);
+        }
+    }
+
+    // the names of the integers the preprocessor wrote instead of package
+    // names (the table is read once when the first answer is written)
+    std::vector<std::string> const &read_symbols_() {
+        if (!symbols_read_) {
+            std::ifstream in{cudf2lp_sym_};
+            size_t id;
+            for (std::string name; in >> id >> name; ) {
+                if (id >= symbols_names_.size()) { symbols_names_.resize(id + 1); }
+                symbols_names_[id] = std::move(name);
+            }
+            symbols_read_ = true;
+        }
+        return symbols_names_;
+    }
+
     void print_usage(char *name) {
         std::cout << "Usage: " << name << " [option]... [cudfin] [cudfout] [criteria]" << std::endl;
     }
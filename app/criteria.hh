@@ -0,0 +1,80 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+
+#pragma once
+
+#include <cudf/critparser.hh>
+#include <boost/algorithm/string.hpp>
+#include <cassert>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+//////////////////// Parse Criteria /////////////////////////// {{{1
+
+inline void option_from_string(char const *value, Criteria::CritVec &target, int) {
+    auto lower = boost::algorithm::to_lower_copy(std::string(value));
+    if (lower == "paranoid") {
+        target.push_back(Criterion());
+        target.back().optimize = false;
+        target.back().measurement = Criterion::COUNT;
+        target.back().selector = Criterion::REMOVED;
+        target.push_back(Criterion());
+        target.back().optimize = false;
+        target.back().measurement = Criterion::COUNT;
+        target.back().selector = Criterion::CHANGED;
+    }
+    else if (lower == "trendy") {
+        target.push_back(Criterion());
+        target.back().optimize = false;
+        target.back().measurement = Criterion::COUNT;
+        target.back().selector = Criterion::REMOVED;
+        target.push_back(Criterion());
+        target.back().optimize = false;
+        target.back().measurement = Criterion::NOTUPTODATE;
+        target.back().selector = Criterion::SOLUTION;
+        target.push_back(Criterion());
+        target.back().optimize = false;
+        target.back().measurement = Criterion::UNSAT_RECOMMENDS;
+        target.back().selector = Criterion::SOLUTION;
+        target.push_back(Criterion());
+        target.back().optimize = false;
+        target.back().measurement = Criterion::COUNT;
+        target.back().selector = Criterion::NEW;
+    }
+    else if (lower == "none") { }
+    else {
+        CritParser p(target);
+        std::istringstream iss(lower);
+        if (!p.parse(iss)) {
+            throw std::runtime_error("invalid criteria");
+        }
+    }
+}
+
+inline std::string option_to_string(Criteria::CritVec const &target) {
+    assert(target.empty());
+    return "none";
+}
@@ -23,67 +23,24 @@
 // }}}
 //////////////////// Preamble /////////////////////////////////// {{{1
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <cudf/version.hh>
 #include <cudf/parser.hh>
 #include <cudf/critparser.hh>
+#include <cudf/aspif.hh>
+#include <cudf/clausewriter.hh>
 #include <stdexcept>
 #include <fstream>
-#include <boost/algorithm/string.hpp>
+#include <thread>
 #include <boost/range/adaptor/reversed.hpp>
+#include "criteria.hh"
 #include "options.hh"
 
 #define CUDF_EXECUTABLE "cudf2lp"
 #define CUDF_USAGE "[option]... [file]"
 
-//////////////////// Parse Criteria ///////////////////////// {{{1
-
-void option_from_string(char const *value, Criteria::CritVec &target, int) {
-    auto lower = boost::algorithm::to_lower_copy(std::string(value));
-    if (lower == "paranoid") {
-        target.push_back(Criterion());
-        target.back().optimize = false;
-        target.back().measurement = Criterion::COUNT;
-        target.back().selector = Criterion::REMOVED;
-        target.push_back(Criterion());
-        target.back().optimize = false;
-        target.back().measurement = Criterion::COUNT;
-        target.back().selector = Criterion::CHANGED;
-    }
-    else if (lower == "trendy") {
-        target.push_back(Criterion());
-        target.back().optimize = false;
-        target.back().measurement = Criterion::COUNT;
-        target.back().selector = Criterion::REMOVED;
-        target.push_back(Criterion());
-        target.back().optimize = false;
-        target.back().measurement = Criterion::NOTUPTODATE;
-        target.back().selector = Criterion::SOLUTION;
-        target.push_back(Criterion());
-        target.back().optimize = false;
-        target.back().measurement = Criterion::UNSAT_RECOMMENDS;
-        target.back().selector = Criterion::SOLUTION;
-        target.push_back(Criterion());
-        target.back().optimize = false;
-        target.back().measurement = Criterion::COUNT;
-        target.back().selector = Criterion::NEW;
-    }
-    else if (lower == "none") { }
-    else {
-        CritParser p(target);
-        std::istringstream iss(lower);
-        if (!p.parse(iss)) {
-            throw std::runtime_error("invalid criteria");
-        }
-    }
-}
-
-std::string option_to_string(Criteria::CritVec const &target) {
-    assert(target.empty());
-    return "none";
-}
-
 //////////////////// main /////////////////////////////////////// {{{1
 
 void printUsage(Options &a) {
@@ -98,9 +55,9 @@ void printVersion() {
 
 int main(int argc, char *argv[]) {
     try {
-        std::string file = "-";
-        bool addall = false, help = false, version = false;
-        unsigned verbositiy = 0;
+        std::string file = "-", symbols, installed, output = "lp";
+        bool addall = false, nodominance = false, nosymmetry = false, noprobing = false, precompute = false, ranges = false, changes = false, check = false, help = false, version = false;
+        unsigned verbositiy = 0, threads = 0, shuffle = 0;
         Criteria::CritVec criteria;
         Options options;
         options.group("Preprocessing Options");
@@ -125,6 +82,23 @@ int main(int argc, char *argv[]) {
             "    unsat_recommends = unsat_recommends(solution)\n"
             "    sum(name)        = sum(name,solution)\n");
         options.add(addall, "a,addall", "Disable preprocessing and add all packages");
+        options.add(nodominance, "no-dominance", "Disable removal of dominated versions");
+        options.add(nosymmetry, "no-symmetry", "Disable symmetry breaking among equivalent versions");
+        options.add(noprobing, "no-probing", "Disable removal of uninstallable versions");
+        options.add(threads, "t,threads", "Number of threads used for probing and writing facts (0 = number of cores)");
+        options.add(shuffle, "shuffle", "Shuffle the order of packages with the given seed (0 = canonical order)");
+        options.add(precompute, "precompute", "Precompute derived relations for encoding misc2012-lean.lp");
+        options.add(ranges, "ranges", "Write consecutive versions satisfying a condition as ranges");
+        options.add(output, "o,output", "Output format\n"
+            "  Accepted values: lp, aspif, wcnf, opb\n"
+            "    lp   : facts for the encodings\n"
+            "    aspif: ground program of encoding specification.lp\n"
+            "    wcnf : weighted partial MaxSAT problem of the program\n"
+            "    opb  : pseudo-Boolean problem of the program");
+        options.add(changes, "changes", "Show only changes to the installed packages in the ground program");
+        options.add(installed, "installed", "Write the installed packages to <file>", nullptr, "file");
+        options.add(symbols, "symbols", "Write package names as integers and their names to <file>", nullptr, "file");
+        options.add(check, "check", "Print uninstallable packages of the universe and exit");
 
         options.group("Basic Options");
         options.add(file, "f,file", "input file", "arg", 1, 0, true);
@@ -143,16 +117,63 @@ int main(int argc, char *argv[]) {
             return EXIT_SUCCESS;
         }
 
-        Dependency d(criteria, addall, verbositiy);
+        if (output != "lp" && output != "aspif" && output != "wcnf" && output != "opb") {
+            throw OptionsException("invalid output format");
+        }
+        if (output != "lp" && (precompute || ranges || !symbols.empty())) {
+            throw OptionsException("options --precompute, --ranges, and --symbols require output format lp");
+        }
+        if (output == "lp" && changes) {
+            throw OptionsException("option --changes requires a ground output format (use constant outPutIn=2 of the encodings instead)");
+        }
+        if (threads == 0) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+        DependencyOptions opts;
+        opts.addAll     = addall;
+        opts.verbose    = verbositiy > 0;
+        opts.dominance  = !nodominance;
+        opts.probing    = !noprobing;
+        opts.threads    = threads;
+        opts.precompute = precompute;
+        opts.ranges     = ranges;
+        opts.shuffle    = shuffle;
+        Dependency d(criteria, opts);
         Parser p(d);
         if (file == "-") { p.parse(std::cin); }
         else {
             std::ifstream in(file.c_str());
             p.parse(in);
         }
+        if (check) {
+            for (Package *pkg : d.broken()) {
+                std::cout << "package: " << d.string(pkg->name) << "\n";
+                std::cout << "version: " << pkg->version << "\n\n";
+            }
+            return EXIT_SUCCESS;
+        }
         d.closure();
+        if (!installed.empty()) {
+            std::ofstream out(installed.c_str());
+            if (!out) { throw std::runtime_error("could not open file: " + installed); }
+            d.dumpInstalled(out);
+        }
         d.conflicts();
-        d.dumpAsFacts(std::cout);
+        if (!nosymmetry) { d.symmetries(); }
+        if (output == "aspif") {
+            FactWriter writer(std::cout, nullptr);
+            AspifWriter prg(writer);
+            d.dumpProgram(prg, changes);
+        }
+        else if (output == "wcnf" || output == "opb") {
+            FactWriter writer(std::cout, nullptr);
+            ClauseWriter prg(writer, output == "wcnf" ? ClauseWriter::WCNF : ClauseWriter::OPB);
+            d.dumpProgram(prg, changes);
+        }
+        else if (!symbols.empty()) {
+            std::ofstream table(symbols.c_str());
+            if (!table) { throw std::runtime_error("could not open symbol table: " + symbols); }
+            d.dumpAsFacts(std::cout, &table);
+        }
+        else { d.dumpAsFacts(std::cout); }
         return EXIT_SUCCESS;
     }
     catch (OptionsException const &e) {
@@ -341,9 +341,11 @@ private:
             if (arg) {
                 description_ += " ";
                 description_ += arg;
-                description_ += " (=";
-                description_ += def;
-                description_ += ")";
+                if (def) {
+                    description_ += " (=";
+                    description_ += def;
+                    description_ += ")";
+                }
             }
             len = description_.size() - len + 3;
             if (std::strchr(desc, '\n') == nullptr && len <= align_column_ && len + strlen(desc) < max_column_) {
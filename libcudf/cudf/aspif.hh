@@ -0,0 +1,50 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble ///////////////////////// {{{1
+
+#pragma once
+
+#include <cudf/factwriter.hh>
+#include <cudf/program.hh>
+
+//////////////////// AspifWriter ////////////////////// {{{1
+
+// Writes a ground program in the intermediate format of clasp (aspif).
+//
+// The header is written on construction.
+class AspifWriter : public GroundProgram {
+public:
+    explicit AspifWriter(FactWriter &out);
+
+    void rule(AtomVec const &head, LitVec const &body, bool choice = false);
+    void minimize(int64_t priority, WeightLitVec const &lits);
+    void output(std::string const &str, LitVec const &cond);
+    void end();
+
+private:
+    // weights and priorities have to fit into 32 bits for the solver
+    static int32_t weight_(int64_t weight);
+
+    FactWriter &out_;
+};
@@ -0,0 +1,70 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble ///////////////////////// {{{1
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+struct Package;
+
+//////////////////// ClausePool /////////////////////// {{{1
+
+// Deduplicates clauses of packages and assigns them consecutive ids starting
+// at 1 in the order of their first insertion.
+//
+// Each clause is stored once in a flat arena. Lookups go through an open
+// addressing table of 64-bit fingerprints; the clauses are only compared
+// element-wise if their fingerprints agree.
+class ClausePool {
+public:
+    typedef std::vector<Package*> Clause;
+
+    ClausePool();
+    // returns the id of the clause and whether it has been added
+    std::pair<uint32_t, bool> insert(Clause const &clause);
+    // as above but with the fingerprint of the clause computed beforehand
+    std::pair<uint32_t, bool> insert(Clause const &clause, uint64_t hash);
+    // the packages of the clause with the given id
+    std::pair<Package * const *, Package * const *> clause(uint32_t id) const;
+    // the number of distinct clauses
+    uint32_t size() const;
+    // the number of fingerprint collisions resolved by comparing clauses
+    uint64_t collisions() const;
+    // the fingerprint of a clause (independent of the state of the pool)
+    static uint64_t fingerprint(Clause const &clause);
+
+private:
+    bool equal_(uint32_t id, Clause const &clause) const;
+    void grow_();
+
+    std::vector<Package*> arena_;
+    std::vector<uint32_t> offsets_;
+    std::vector<uint64_t> fingerprints_;
+    std::vector<uint32_t> table_;
+    uint64_t              collisions_ = 0;
+};
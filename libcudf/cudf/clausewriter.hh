@@ -0,0 +1,71 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble ///////////////////////// {{{1
+
+#pragma once
+
+#include <cudf/factwriter.hh>
+#include <cudf/program.hh>
+
+#include <map>
+
+//////////////////// ClauseWriter ///////////////////// {{{1
+
+// Writes a ground program as weighted partial MaxSAT problem (WCNF) or as
+// pseudo-Boolean optimization problem (OPB).
+//
+// The program is translated via its completion and has to be tight. The
+// minimize statements are combined into a single objective by multiplying
+// the weights of each priority level with the sum of the weights of all
+// lower levels plus one. Shown atoms are written as comments of form
+//
+//   c show <variable> <string>   (WCNF)
+//   * show <variable> <string>   (OPB)
+//
+// where variables of OPB are written as x<variable> in the problem.
+class ClauseWriter : public GroundProgram {
+public:
+    enum Format { WCNF, OPB };
+
+    ClauseWriter(FactWriter &out, Format format);
+
+    void rule(AtomVec const &head, LitVec const &body, bool choice = false);
+    void minimize(int64_t priority, WeightLitVec const &lits);
+    void output(std::string const &str, LitVec const &cond);
+    void end();
+
+    uint32_t clauses() const { return clauses_.size(); }
+
+private:
+    void clause_(LitVec clause);
+    void literal_(Literal lit);
+
+    FactWriter                  &out_;
+    Format                       format_;
+    std::vector<std::vector<LitVec>> bodies_;
+    std::vector<bool>            choice_;
+    std::vector<LitVec>          clauses_;
+    std::map<int64_t, WeightLitVec> levels_;
+    std::vector<std::pair<std::string, Atom>> shown_;
+};
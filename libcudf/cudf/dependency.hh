@@ -26,7 +26,11 @@
 #pragma once
 
 #include <cudf/packages.hh>
+#include <cudf/clausepool.hh>
+#include <cudf/factwriter.hh>
+#include <cudf/program.hh>
 
+#include <boost/dynamic_bitset.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/random_access_index.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -41,11 +45,15 @@ struct Package;
 struct Feature;
 class Dependency;
 class ConflictGraph;
+class Propagator;
 
 typedef std::vector<Entity*>    EntityList;
 typedef std::vector<EntityList> EntityFormula;
 typedef std::vector<Feature*>   FeatureList;
 typedef std::vector<Package*>   PackageList;
+typedef std::vector<PackageList> ClauseList;
+// ids of conditions and whether they are written for the first time
+typedef std::vector<std::pair<uint32_t, bool>> ConditionList;
 
 //////////////////// Criterion //////////////////////// {{{1
 
@@ -53,7 +61,6 @@ struct Criterion
 {
     enum Selector { SOLUTION, CHANGED, NEW, REMOVED, UP, DOWN, INSTALLREQUEST, UPGRADEREQUEST, REQUEST };
     enum Measurement { COUNT, SUM, NOTUPTODATE, UNSAT_RECOMMENDS, ALIGNED };
-    typedef boost::unordered_map<uint32_t, std::set<uint32_t> > AlignedMap;
 
     bool optimize;
     Measurement measurement;
@@ -62,7 +69,6 @@ struct Criterion
     std::string attr2;
     uint32_t attrUid1;
     uint32_t attrUid2;
-    AlignedMap optAligned;
 };
 
 //////////////////// Criteria ///////////////////////// {{{1
@@ -89,7 +95,7 @@ struct Entity {
 
     uint32_t addClause();
     virtual void doAdd(Dependency *dep) = 0;
-    virtual void dumpAsFacts(Dependency *dep, std::ostream &out) = 0;
+    virtual void dumpAsFacts(Dependency *dep, FactWriter &out, ConditionList const &conds) = 0;
     virtual void addToClause(PackageList &clause, Package *self = 0) = 0;
     virtual void addConflictEdges(ConflictGraph &g) = 0;
     bool allVersions() const;
@@ -121,14 +127,17 @@ struct Package : public Entity {
     };
 
     Package(const Cudf::Package &pkg);
-    void dumpAsFacts(Dependency *dep, std::ostream &out);
-    void dumpAttrs(Dependency *dep, std::ostream &out);
-    void dumpAttr(Dependency *dep, std::ostream &out, unsigned uid);
+    // the clauses of dependencies and conflicts in the order of dumpAsFacts
+    void factClauses(ClauseList &clauses);
+    void dumpAsFacts(Dependency *dep, FactWriter &out, ConditionList const &conds);
+    // whether recommendations and which attributes are needed for the criteria
+    void criteriaAttrs(Dependency *dep, bool &recom, std::set<uint32_t> &attr);
+    // the clauses of recommendations in the order of dumpAttrs
+    void attrClauses(Dependency *dep, ClauseList &clauses);
+    void dumpAttrs(Dependency *dep, FactWriter &out, ConditionList const &conds);
     void addToClause(PackageList &clause, Package *self = 0);
     void addConflictEdges(ConflictGraph &g);
     bool satisfies(Criterion::Selector sel);
-    Relevant relevant(bool optimize, Criterion::Selector sel);
-    unsigned relevant(Criterion &crit);
     uint32_t getProp(uint32_t uid) const;
     void doAdd(Dependency *dep);
 
@@ -147,6 +156,12 @@ struct Package : public Entity {
     bool optInInstall;
     bool optInUpgrade;
     bool dfsVisited;
+    // the package has to be installed in every solution
+    bool fixed;
+    // position in the package list of the dependency
+    uint32_t id;
+    // representative of the packages that have to be installed together
+    Package *scc;
 
 protected:
     void doRemove(Dependency *dep);
@@ -156,7 +171,7 @@ protected:
 
 struct Feature : public Entity {
     Feature(const Cudf::PackageRef &ftr);
-    void dumpAsFacts(Dependency *dep, std::ostream &out);
+    void dumpAsFacts(Dependency *dep, FactWriter &out, ConditionList const &conds);
     void addToClause(PackageList &clause, Package *self = 0);
     void doAdd(Dependency *dep);
     void addConflictEdges(ConflictGraph &g);
@@ -185,7 +200,7 @@ class ConflictGraph {
 public:
     void addEdges(Package *a, PackageList const &neighbors);
     void init(bool verbose);
-    void dump(Dependency *dep, std::ostream &out);
+    void dump(FactWriter &out);
     bool edgeSort(Package *a, Package *b);
 private:
     void components_(bool verbose);
@@ -199,8 +214,10 @@ private:
     };
     typedef boost::unordered_map<Package*, PackageList, ConflictGraph::PkgHash> Edges;
     typedef boost::unordered_set<std::pair<Package*, Package*> > EdgeSet;
+    typedef boost::unordered_map<uint32_t, uint32_t> NameMap;
     EdgeSet edgeSet_;
     Edges edges_;
+    NameMap names_;
 public:
     typedef std::vector<PackageList> Components;
     Components components;
@@ -209,11 +226,31 @@ public:
 
 //////////////////// Dependency /////////////////////// {{{1
 
+struct DependencyOptions {
+    // add all packages instead of only the ones in the closure
+    bool     addAll     = false;
+    bool     verbose    = true;
+    bool     dominance  = true;
+    bool     probing    = true;
+    unsigned threads    = 1;
+    // write the relations of the packages to the cliques of the conflict graph
+    bool     precompute = false;
+    // write version ranges instead of individual versions
+    bool     ranges     = false;
+    // seed to shuffle the packages with (0 keeps the canonical order)
+    unsigned shuffle    = 0;
+};
+
 class Dependency {
 public:
+    typedef boost::dynamic_bitset<>                     Bitset;
     typedef boost::unordered_map<uint32_t, EntityList>  EntityMap;
     typedef std::vector<Request>                        RequestList;
-    typedef boost::unordered_map<PackageList, uint32_t> ClauseMap;
+    typedef std::vector<PackageList>                    PackageFormula;
+    // relations of packages to clauses as in the encoding; the order of the
+    // kinds agrees with the order of the corresponding ASP constants
+    enum Relation : uint64_t { CON = 0, DEP = 1, REC = 2, SAT = 3 };
+    typedef std::vector<std::vector<uint64_t>>          RelationList;
     friend struct Package;
 private:
     typedef std::vector<std::unique_ptr<Package>> PackageSet;
@@ -226,39 +263,91 @@ private:
     > StringSet;
 
 public:
-    Dependency(Criteria::CritVec &crits, bool addAll, bool verbose = true);
+    Dependency(Criteria::CritVec &crits, DependencyOptions const &opts = DependencyOptions());
     uint32_t index(const std::string &s);
     uint32_t index(const char *s);
     const std::string &string(uint32_t index);
     void init(const Cudf::Document &doc);
     void closure();
     void conflicts();
+    void symmetries();
+    // packages that cannot be installed because of their dependencies and
+    // conflicts (independent of the request)
+    PackageList broken();
     void add(Entity *ent);
-    uint32_t addClause(PackageList &list, std::ostream &out);
-    void dumpAsFacts(std::ostream &out);
+    uint32_t addClause(PackageList &list, FactWriter &out);
+    // package names are written as integers if a symbol table is given
+    void dumpAsFacts(std::ostream &out, std::ostream *symbols = nullptr);
+    // passes the ground program of encoding specification.lp for the facts
+    // to the given output format (showing only the changes to the installed
+    // packages if requested)
+    void dumpProgram(GroundProgram &prg, bool changes = false);
+    // writes the installed packages as lines of form "name version candidate"
+    // where candidate is 0 if the package cannot be installed anymore after
+    // the closure has been computed
+    void dumpInstalled(std::ostream &out);
     bool addAll() const;
+    // common divisor of the values of an attribute only used by sum
+    // criteria (or 0 if the values are not scaled)
+    int64_t scale(uint32_t uid) const;
 
-    // WARNING: for testing the implementation of this is highly inefficient
+    // WARNING: for testing the implementation of these is highly inefficient
     bool test_contains(std::string const &name, int32_t version);
+    bool test_fixed(std::string const &name, int32_t version);
+    bool test_removed(std::string const &name, int32_t version);
+    uint32_t test_depends(std::string const &name, int32_t version);
+    bool test_condensed(std::string const &a, int32_t va, std::string const &b, int32_t vb);
+    bool test_symmetric(std::string const &name, int32_t a, int32_t b);
 
 private:
+    void reorder();
+    void initAttributes();
     void initClosure();
+    void markRelevant();
     void rewriteRequests();
+    void initPropagator(Propagator &prop, bool requests);
+    bool probe(Propagator &prop, uint32_t &broken);
+    void propagate();
+    void dominate();
+    void subsume();
+    void condense();
+    void relate(Package *pkg, Relation rel, uint32_t clause);
+    void initSuccessors();
+    // adds a sorted clause and relates its packages if it is new
+    std::pair<uint32_t, bool> insertClause(PackageList const &clause, uint64_t fingerprint);
+    void dumpClause(uint32_t condition, FactWriter &out);
+    void dumpPackages(FactWriter &out);
+    void initScales();
+    void dumpAsFacts(FactWriter &out);
+    void dumpObjectives(FactWriter &out);
+    void dumpCliqueRelations(FactWriter &out);
 
 public:
     Criteria    criteria;
 
 private:
-    StringSet     strings_;
-    PackageSet    packages_;
-    FeatureSet    features_;
-    EntityMap     entityMap_;
-    EntityList    remove_;
-    RequestList   install_;
-    RequestList   upgrade_;
-    EntityList    closure_;
-    ClauseMap     clauses_;
-    ConflictGraph conflictGraph_;
-    bool          verbose_;
-    bool          addAll_;
+    StringSet      strings_;
+    PackageSet     packages_;
+    FeatureSet     features_;
+    EntityMap      entityMap_;
+    EntityList     remove_;
+    RequestList    install_;
+    RequestList    upgrade_;
+    EntityList     closure_;
+    ClausePool     clauses_;
+    ConflictGraph  conflictGraph_;
+    PackageFormula symmetries_;
+    RelationList   relations_;
+    // the next higher version with the same name of the packages in the
+    // closure (used to write version ranges)
+    PackageList    successors_;
+    std::map<uint32_t, int64_t> scales_;
+    bool           verbose_;
+    bool           addAll_;
+    bool           dominance_;
+    bool           probing_;
+    unsigned       threads_;
+    bool           precompute_;
+    bool           ranges_;
+    unsigned       shuffle_;
 };
@@ -0,0 +1,107 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble ///////////////////////// {{{1
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//////////////////// FactWriter /////////////////////// {{{1
+
+// Buffers facts and writes them to an output stream in large blocks.
+//
+// Integers are formatted without going through the locale machinery of the
+// stream and interned strings written with Quoted are cached in their quoted
+// form. Package names are written with Symbol; if a symbol table is set, they
+// are replaced by dense integers starting at 1 and each integer is recorded
+// with its name on a line of the table.
+class FactWriter {
+public:
+    typedef std::function<std::string const &(uint32_t)> Resolver;
+    // an interned string to be written in double quotes
+    struct Quoted {
+        uint32_t index;
+    };
+    // an interned package name
+    struct Symbol {
+        uint32_t index;
+    };
+
+    FactWriter(std::ostream &out, Resolver resolve, size_t capacity = 1 << 20);
+    FactWriter(FactWriter const &) = delete;
+    FactWriter &operator=(FactWriter const &) = delete;
+    ~FactWriter();
+
+    FactWriter &operator<<(char c) {
+        reserve_(1);
+        buf_[size_++] = c;
+        return *this;
+    }
+    FactWriter &operator<<(char const *str) { return write(str, std::strlen(str)); }
+    FactWriter &operator<<(std::string const &str) { return write(str.data(), str.size()); }
+    FactWriter &operator<<(Quoted str);
+    FactWriter &operator<<(Symbol sym);
+    template <class T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    FactWriter &operator<<(T num) {
+        // enough for the digits of 64-bit integers and a sign
+        char tmp[24];
+        char *end = tmp + sizeof(tmp), *it = end;
+        bool neg = num < 0;
+        typename std::make_unsigned<T>::type val = neg ? 0 - static_cast<typename std::make_unsigned<T>::type>(num) : num;
+        do {
+            *--it = static_cast<char>('0' + val % 10);
+            val /= 10;
+        } while (val != 0);
+        if (neg) { *--it = '-'; }
+        return write(it, end - it);
+    }
+    FactWriter &write(char const *str, size_t len);
+    // writes the buffered facts to the stream
+    void flush();
+    // writes package names as integers and records them in the given table
+    void symbols(std::ostream &table);
+    // whether package names are written as integers
+    bool symbolic() const { return table_ != nullptr; }
+
+private:
+    void reserve_(size_t len) {
+        if (size_ + len > buf_.size()) { flush(); }
+    }
+
+    std::ostream            &out_;
+    Resolver                 resolve_;
+    std::vector<char>        buf_;
+    size_t                   size_ = 0;
+    std::vector<std::string> quoted_;
+    std::ostream            *table_ = nullptr;
+    std::vector<uint32_t>    symbols_;
+    uint32_t                 numSymbols_ = 0;
+};
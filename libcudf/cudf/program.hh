@@ -0,0 +1,78 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble ///////////////////////// {{{1
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+//////////////////// GroundProgram //////////////////// {{{1
+
+// Receives a ground logic program and writes it in some output format.
+//
+// Atoms are numbered consecutively starting at 1 and literals are atoms or
+// their negation. The program has to be terminated with end().
+class GroundProgram {
+public:
+    typedef uint32_t Atom;
+    typedef int32_t Literal;
+    typedef std::vector<Atom> AtomVec;
+    typedef std::vector<Literal> LitVec;
+    typedef std::vector<std::pair<Literal, int64_t>> WeightLitVec;
+
+    GroundProgram() = default;
+    GroundProgram(GroundProgram const &) = delete;
+    GroundProgram &operator=(GroundProgram const &) = delete;
+    virtual ~GroundProgram() = default;
+
+    // a fresh atom
+    Atom atom() { return ++atoms_; }
+    // an atom that is true in every answer set
+    Atom top() {
+        if (top_ == 0) {
+            top_ = atom();
+            rule({top_}, {});
+        }
+        return top_;
+    }
+    // a disjunctive or choice rule; constraints have an empty head
+    virtual void rule(AtomVec const &head, LitVec const &body, bool choice = false) = 0;
+    virtual void minimize(int64_t priority, WeightLitVec const &lits) = 0;
+    // shows the string if the literals of the condition hold
+    virtual void output(std::string const &str, LitVec const &cond) = 0;
+    virtual void end() = 0;
+
+    uint32_t atoms() const { return atoms_; }
+    uint32_t rules() const { return rules_; }
+
+protected:
+    uint32_t rules_ = 0;
+
+private:
+    Atom     top_ = 0;
+    uint32_t atoms_ = 0;
+};
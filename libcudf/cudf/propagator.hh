@@ -0,0 +1,94 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble ///////////////////////// {{{1
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+//////////////////// Propagator /////////////////////// {{{1
+
+// Unit propagation over the dependencies, conflicts, and requests of a set of
+// packages identified by consecutive ids.
+//
+// A package is fixed to true if it has to be installed in every solution and
+// fixed to false if it cannot be installed in any solution.
+class Propagator {
+public:
+    enum Value : uint8_t { FREE = 0, TRUE = 1, FALSE = 2 };
+    typedef std::vector<uint32_t> Clause;
+
+    Propagator(uint32_t size);
+    // if pkg is installed then one of the packages in clause has to be installed
+    void addDepends(uint32_t pkg, Clause const &clause);
+    // packages a and b cannot be installed together
+    // (a package conflicting with itself cannot be installed at all)
+    void addConflict(uint32_t a, uint32_t b);
+    // one of the packages in clause has to be installed
+    void addRequest(Clause const &clause);
+    // assigns a value to a package (propagated with the next call to
+    // propagate) and returns false if the package already has another value
+    bool assign(uint32_t pkg, Value val);
+    // propagates all constraints and returns false if they are unsatisfiable
+    bool propagate();
+    // the free packages whose installation leads to a conflict under unit
+    // propagation; the packages are probed in parallel using the given
+    // number of threads and are returned in ascending order
+    Clause failed(unsigned threads) const;
+    Value value(uint32_t pkg) const;
+    uint32_t size() const;
+
+private:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    struct ClauseInfo {
+        uint32_t offset;
+        uint32_t size;
+        uint32_t owner;
+    };
+    // a (partial) assignment together with the order in which packages have
+    // been assigned; probes work on copies of the top-level assignment
+    struct State {
+        State(uint32_t size) : values(size, FREE) { }
+        std::vector<Value>    values;
+        std::vector<uint32_t> trail;
+        size_t                head = 0;
+    };
+    typedef std::vector<std::vector<uint32_t>> Index;
+
+    uint32_t addClause_(uint32_t owner, Clause const &clause);
+    bool assign_(State &state, uint32_t pkg, Value val) const;
+    bool check_(State &state, uint32_t clause) const;
+    bool propagate_(State &state) const;
+    bool probe_(State &state, uint32_t pkg, std::vector<bool> &implied) const;
+
+    std::vector<uint32_t>   lits_;
+    std::vector<ClauseInfo> clauses_;
+    Index                   occurs_;
+    Index                   depends_;
+    Index                   conflicts_;
+    State                   state_;
+};
@@ -0,0 +1,68 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble ///////////////////////// {{{1
+
+#include <cudf/aspif.hh>
+#include <limits>
+#include <stdexcept>
+
+//////////////////// AspifWriter ////////////////////// {{{1
+
+AspifWriter::AspifWriter(FactWriter &out)
+    : out_(out) {
+    out_ << "asp 1 0 0\n";
+}
+
+void AspifWriter::rule(AtomVec const &head, LitVec const &body, bool choice) {
+    out_ << "1 " << (choice ? 1 : 0) << ' ' << head.size();
+    for (Atom atom : head) { out_ << ' ' << atom; }
+    out_ << " 0 " << body.size();
+    for (Literal lit : body) { out_ << ' ' << lit; }
+    out_ << '\n';
+    ++rules_;
+}
+
+void AspifWriter::minimize(int64_t priority, WeightLitVec const &lits) {
+    out_ << "2 " << weight_(priority) << ' ' << lits.size();
+    for (auto &lit : lits) { out_ << ' ' << lit.first << ' ' << weight_(lit.second); }
+    out_ << '\n';
+}
+
+void AspifWriter::output(std::string const &str, LitVec const &cond) {
+    out_ << "4 " << str.size() << ' ' << str << ' ' << cond.size();
+    for (Literal lit : cond) { out_ << ' ' << lit; }
+    out_ << '\n';
+}
+
+void AspifWriter::end() {
+    out_ << "0\n";
+    out_.flush();
+}
+
+int32_t AspifWriter::weight_(int64_t weight) {
+    if (weight < std::numeric_limits<int32_t>::min() || weight > std::numeric_limits<int32_t>::max()) {
+        throw std::runtime_error("weight out of range of the solver");
+    }
+    return static_cast<int32_t>(weight);
+}
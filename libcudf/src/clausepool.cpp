@@ -0,0 +1,102 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble ///////////////////////// {{{1
+
+#include <cudf/clausepool.hh>
+#include <algorithm>
+
+//////////////////// ClausePool /////////////////////// {{{1
+
+ClausePool::ClausePool()
+    : offsets_{0}
+    , fingerprints_{0}
+    , table_(1024, 0) { }
+
+std::pair<uint32_t, bool> ClausePool::insert(Clause const &clause) {
+    return insert(clause, fingerprint(clause));
+}
+
+std::pair<uint32_t, bool> ClausePool::insert(Clause const &clause, uint64_t hash) {
+    size_t mask = table_.size() - 1;
+    size_t slot = hash & mask;
+    for (; table_[slot] != 0; slot = (slot + 1) & mask) {
+        uint32_t id = table_[slot];
+        if (fingerprints_[id] == hash) {
+            if (equal_(id, clause)) { return {id, false}; }
+            ++collisions_;
+        }
+    }
+    uint32_t id = static_cast<uint32_t>(fingerprints_.size());
+    arena_.insert(arena_.end(), clause.begin(), clause.end());
+    offsets_.emplace_back(static_cast<uint32_t>(arena_.size()));
+    fingerprints_.emplace_back(hash);
+    table_[slot] = id;
+    // keep the load factor below one half
+    if (2 * size() > table_.size()) { grow_(); }
+    return {id, true};
+}
+
+std::pair<Package * const *, Package * const *> ClausePool::clause(uint32_t id) const {
+    return {arena_.data() + offsets_[id - 1], arena_.data() + offsets_[id]};
+}
+
+uint32_t ClausePool::size() const {
+    return static_cast<uint32_t>(fingerprints_.size() - 1);
+}
+
+uint64_t ClausePool::collisions() const {
+    return collisions_;
+}
+
+uint64_t ClausePool::fingerprint(Clause const &clause) {
+    // FNV-1a over the pointers followed by the finalizer of splitmix64
+    uint64_t hash = 0xcbf29ce484222325ULL ^ clause.size();
+    for (Package *pkg : clause) {
+        hash ^= reinterpret_cast<uintptr_t>(pkg);
+        hash *= 0x100000001b3ULL;
+    }
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+bool ClausePool::equal_(uint32_t id, Clause const &clause) const {
+    auto range = this->clause(id);
+    return static_cast<size_t>(range.second - range.first) == clause.size() &&
+           std::equal(range.first, range.second, clause.begin());
+}
+
+void ClausePool::grow_() {
+    std::vector<uint32_t> table(2 * table_.size(), 0);
+    size_t mask = table.size() - 1;
+    for (uint32_t id = 1, ie = static_cast<uint32_t>(fingerprints_.size()); id != ie; ++id) {
+        size_t slot = fingerprints_[id] & mask;
+        while (table[slot] != 0) { slot = (slot + 1) & mask; }
+        table[slot] = id;
+    }
+    table_.swap(table);
+}
@@ -0,0 +1,192 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble ///////////////////////// {{{1
+
+#include <cudf/clausewriter.hh>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+
+//////////////////// ClauseWriter ///////////////////// {{{1
+
+ClauseWriter::ClauseWriter(FactWriter &out, Format format)
+    : out_(out)
+    , format_(format) { }
+
+void ClauseWriter::rule(AtomVec const &head, LitVec const &body, bool choice) {
+    ++rules_;
+    if (head.empty()) {
+        // constraints are clauses over the negated body
+        LitVec clause;
+        for (Literal lit : body) { clause.emplace_back(-lit); }
+        clause_(std::move(clause));
+        return;
+    }
+    for (Atom atom : head) {
+        assert(choice || head.size() == 1);
+        if (atom >= bodies_.size()) {
+            bodies_.resize(atom + 1);
+            choice_.resize(atom + 1, false);
+        }
+        if (choice) {
+            // atoms of choice rules with empty bodies are unconstrained
+            assert(body.empty());
+            choice_[atom] = true;
+        }
+        else { bodies_[atom].emplace_back(body); }
+    }
+}
+
+void ClauseWriter::minimize(int64_t priority, WeightLitVec const &lits) {
+    WeightLitVec &level = levels_[priority];
+    level.insert(level.end(), lits.begin(), lits.end());
+}
+
+void ClauseWriter::output(std::string const &str, LitVec const &cond) {
+    if (cond.size() == 1 && cond.front() > 0) { shown_.emplace_back(str, cond.front()); }
+    else {
+        Atom atom = this->atom();
+        rule({atom}, cond);
+        shown_.emplace_back(str, atom);
+    }
+}
+
+void ClauseWriter::clause_(LitVec clause) {
+    clauses_.emplace_back(std::move(clause));
+}
+
+void ClauseWriter::literal_(Literal lit) {
+    if (format_ == WCNF) { out_ << lit; }
+    else {
+        out_ << (lit < 0 ? "~x" : "x") << (lit < 0 ? -lit : lit);
+    }
+}
+
+void ClauseWriter::end() {
+    // completion: an atom holds iff one of its bodies holds
+    bodies_.resize(atoms() + 1);
+    choice_.resize(atoms() + 1, false);
+    for (Atom atom = 1, last = atoms(); atom <= last; ++atom) {
+        LitVec support{-static_cast<Literal>(atom)};
+        bool fact = false;
+        for (LitVec &body : bodies_[atom]) {
+            if (body.empty()) {
+                fact = true;
+                clause_({static_cast<Literal>(atom)});
+                continue;
+            }
+            Literal lit = body.front();
+            if (body.size() > 1) {
+                lit = this->atom();
+                LitVec clause{lit};
+                for (Literal elem : body) {
+                    clause_({-lit, elem});
+                    clause.emplace_back(-elem);
+                }
+                clause_(std::move(clause));
+            }
+            clause_({-lit, static_cast<Literal>(atom)});
+            support.emplace_back(lit);
+        }
+        if (!fact && !choice_[atom]) { clause_(std::move(support)); }
+    }
+    bodies_.clear();
+    // objective: weights are made positive by negating literals and
+    // priority levels are stratified starting with the lowest one
+    int64_t const max = std::numeric_limits<int64_t>::max();
+    WeightLitVec objective;
+    int64_t factor = 1, sum = 0;
+    for (auto &level : levels_) {
+        int64_t levelSum = 0;
+        for (auto &lit : level.second) {
+            if (lit.second == 0) { continue; }
+            if (lit.second < 0) {
+                lit.first = -lit.first;
+                lit.second = -lit.second;
+            }
+            if (lit.second > max / factor || lit.second * factor > max - levelSum - sum - 1) {
+                throw std::overflow_error("weights of the objective exceed 64 bits");
+            }
+            lit.second *= factor;
+            levelSum += lit.second;
+            objective.emplace_back(lit);
+        }
+        sum += levelSum;
+        factor = sum + 1;
+    }
+    levels_.clear();
+    // an empty clause is written to OPB as the unsatisfiable constraint
+    // 0 x1 >= 1, so at least one variable has to exist
+    if (format_ == OPB && atoms() == 0 && std::any_of(clauses_.begin(), clauses_.end(), [](LitVec const &clause) { return clause.empty(); })) {
+        this->atom();
+    }
+    // header and shown atoms
+    char const *comment = format_ == WCNF ? "c" : "*";
+    if (format_ == WCNF) {
+        out_ << "p wcnf " << atoms() << " " << clauses_.size() + objective.size() << " " << sum + 1 << "\n";
+    }
+    else {
+        out_ << "* #variable= " << atoms() << " #constraint= " << clauses_.size() << "\n";
+    }
+    for (auto &shown : shown_) {
+        out_ << comment << " show " << shown.second << " " << shown.first << "\n";
+    }
+    // objective and clauses
+    if (format_ == WCNF) {
+        for (auto &lit : objective) {
+            out_ << lit.second << " ";
+            literal_(-lit.first);
+            out_ << " 0\n";
+        }
+        for (LitVec &clause : clauses_) {
+            out_ << sum + 1;
+            for (Literal lit : clause) {
+                out_ << " ";
+                literal_(lit);
+            }
+            out_ << " 0\n";
+        }
+    }
+    else {
+        if (!objective.empty()) {
+            out_ << "min:";
+            for (auto &lit : objective) {
+                out_ << " +" << lit.second << " ";
+                literal_(lit.first);
+            }
+            out_ << " ;\n";
+        }
+        for (LitVec &clause : clauses_) {
+            if (clause.empty()) { out_ << "+0 x1 "; }
+            for (Literal lit : clause) {
+                out_ << "+1 ";
+                literal_(lit);
+                out_ << " ";
+            }
+            out_ << ">= 1 ;\n";
+        }
+    }
+    out_.flush();
+}
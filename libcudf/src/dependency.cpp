@@ -24,13 +24,24 @@
 //////////////////// Preamble ///////////////////////// {{{1
 
 #include <cudf/dependency.hh>
+#include <cudf/propagator.hh>
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/algorithm/sort.hpp>
 #include <boost/range/algorithm/unique.hpp>
 #include <boost/range/algorithm/find.hpp>
+#include <boost/range/algorithm/find_if.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <thread>
 #include <typeinfo>
+#include <tuple>
+#include <utility>
 #include <map>
 
 //////////////////// Helper /////////////////////////// {{{1
@@ -47,6 +58,26 @@ namespace {
         t.resize(boost::range::unique(boost::range::sort(t)).size());
     }
 
+    // packages are ordered by their position in the package list (and not by
+    // their addresses) to obtain the same order on all platforms
+    void sort_uniq(PackageList &t) {
+        t.resize(boost::range::unique(boost::range::sort(t, [](Package *a, Package *b) { return a->id < b->id; })).size());
+    }
+
+    // calls fun(thread, begin, end) for consecutive chunks of the range
+    // [0, size) on the given number of threads
+    template <class F>
+    void parallel_chunks(unsigned threads, size_t size, F fun) {
+        threads = std::max(1u, static_cast<unsigned>(std::min<size_t>(threads, size)));
+        size_t chunk = (size + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        for (unsigned thread = 1; thread < threads; ++thread) {
+            workers.emplace_back(fun, thread, std::min(size, thread * chunk), std::min(size, (thread + 1) * chunk));
+        }
+        fun(0, 0, std::min(size, chunk));
+        for (std::thread &worker : workers) { worker.join(); }
+    }
+
     struct CudfPackageRefFilter {
         CudfPackageRefFilter(const Cudf::PackageRef &ref) : ref(&ref) { }
         bool operator()(const Entity *entity) const {
@@ -90,6 +121,511 @@ namespace {
     }
 
 #undef refRange
+
+    typedef Dependency::Bitset Bitset;
+
+    // packages that have to be added to the closure stored as bitsets over
+    // package ids (see Package::Relevant for the meaning of the sets)
+    struct Relevance {
+        Relevance(size_t n) : self(n), equal(n), recommended(n) { }
+
+        Bitset self;
+        Bitset equal;
+        Bitset recommended;
+    };
+
+    // package attributes relevant for criteria stored column-wise as bitsets
+    // over package ids; this way the relevant packages for a criterion can be
+    // computed with a few bit operations over all packages at once
+    class Columns {
+    public:
+        typedef std::vector<std::unique_ptr<Package>> Packages;
+
+        Columns(Packages const &packages)
+            : packages_(packages)
+            , all(packages.size())
+            , removed(packages.size())
+            , installed(packages.size())
+            , nameInstalled(packages.size())
+            , maxVersion(packages.size())
+            , gtMaxInstalled(packages.size())
+            , ltMinInstalled(packages.size())
+            , inInstall(packages.size())
+            , inUpgrade(packages.size())
+            , recommends(packages.size()) {
+            all.set();
+            for (auto &pkg : packages) {
+                removed[pkg->id]        = pkg->remove_;
+                installed[pkg->id]      = pkg->installed;
+                nameInstalled[pkg->id]  = pkg->optInstalled;
+                maxVersion[pkg->id]     = pkg->optMaxVersion;
+                gtMaxInstalled[pkg->id] = pkg->optGtMaxInstalled;
+                ltMinInstalled[pkg->id] = pkg->optLtMinInstalled;
+                inInstall[pkg->id]      = pkg->optInInstall;
+                inUpgrade[pkg->id]      = pkg->optInUpgrade;
+                recommends[pkg->id]     = !pkg->recommends.empty();
+            }
+        }
+
+        // the packages satisfying the given selector (see Package::satisfies)
+        Bitset const &select(Criterion::Selector sel) {
+            Bitset &ret = selected_[sel];
+            if (ret.empty()) {
+                switch (sel) {
+                    case Criterion::SOLUTION:       { ret = ~removed; break; }
+                    case Criterion::CHANGED:        { ret = ~removed | installed; break; }
+                    case Criterion::NEW:            { ret = ~removed - nameInstalled; break; }
+                    case Criterion::REMOVED:        { ret = installed; break; }
+                    case Criterion::UP:             { ret = gtMaxInstalled - removed; break; }
+                    case Criterion::DOWN:           { ret = ltMinInstalled - removed; break; }
+                    case Criterion::INSTALLREQUEST: { ret = inInstall - removed; break; }
+                    case Criterion::UPGRADEREQUEST: { ret = inUpgrade - removed; break; }
+                    case Criterion::REQUEST:        { ret = (inInstall | inUpgrade) - removed; break; }
+                }
+            }
+            return ret;
+        }
+
+        // add the packages in mask satisfying the selector to the reason sets
+        void relevant(Criterion::Selector sel, bool maximize, Bitset const &mask, Relevance &rel) {
+            switch (sel) {
+                case Criterion::CHANGED: {
+                    rel.self |= (maximize ? mask - installed : mask & installed) - removed;
+                    break;
+                }
+                case Criterion::REMOVED: {
+                    if (!maximize) { rel.equal |= mask & select(sel); }
+                    break;
+                }
+                default: {
+                    if (maximize) { rel.self |= mask & select(sel); }
+                    break;
+                }
+            }
+        }
+
+        // packages whose first attribute value is shared with a package
+        // having a different second attribute value
+        Bitset aligned(Criterion const &crit) {
+            // maps the first attribute to the first value of the second
+            // attribute and whether there is more than one value
+            typedef boost::unordered_map<uint32_t, std::pair<uint32_t, bool>> AlignedMap;
+            AlignedMap map;
+            map.reserve(packages_.size());
+            for (auto &pkg : packages_) {
+                uint32_t value = pkg->getProp(crit.attrUid2);
+                auto res = map.emplace(pkg->getProp(crit.attrUid1), std::make_pair(value, false));
+                if (!res.second && res.first->second.first != value) { res.first->second.second = true; }
+            }
+            Bitset ret(packages_.size());
+            for (auto &pkg : packages_) {
+                ret[pkg->id] = map.find(pkg->getProp(crit.attrUid1))->second.second;
+            }
+            return ret;
+        }
+
+        // packages with a positive or negative integer attribute
+        void sign(uint32_t uid, Bitset &positive, Bitset &negative) {
+            positive.resize(packages_.size());
+            negative.resize(packages_.size());
+            for (auto &pkg : packages_) {
+                auto it = pkg->intProps.find(uid);
+                if (it != pkg->intProps.end()) {
+                    positive[pkg->id] = it->second > 0;
+                    negative[pkg->id] = it->second < 0;
+                }
+            }
+        }
+
+    private:
+        Packages const &packages_;
+        std::map<Criterion::Selector, Bitset> selected_;
+
+    public:
+        Bitset all;
+        Bitset removed;
+        Bitset installed;
+        Bitset nameInstalled;
+        Bitset maxVersion;
+        Bitset gtMaxInstalled;
+        Bitset ltMinInstalled;
+        Bitset inInstall;
+        Bitset inUpgrade;
+        Bitset recommends;
+    };
+
+    // computes the packages relevant for a criterion; there is one
+    // specialization per measurement
+    template <Criterion::Measurement M>
+    struct Kernel;
+
+    template <>
+    struct Kernel<Criterion::COUNT> {
+        static void apply(Columns &cols, Criterion const &crit, Relevance &rel) {
+            cols.relevant(crit.selector, crit.optimize, cols.all, rel);
+        }
+    };
+
+    template <>
+    struct Kernel<Criterion::NOTUPTODATE> {
+        static void apply(Columns &cols, Criterion const &crit, Relevance &rel) {
+            cols.relevant(crit.selector, crit.optimize, ~cols.maxVersion, rel);
+        }
+    };
+
+    template <>
+    struct Kernel<Criterion::ALIGNED> {
+        static void apply(Columns &cols, Criterion const &crit, Relevance &rel) {
+            cols.relevant(crit.selector, crit.optimize, cols.aligned(crit), rel);
+        }
+    };
+
+    template <>
+    struct Kernel<Criterion::UNSAT_RECOMMENDS> {
+        static void apply(Columns &cols, Criterion const &crit, Relevance &rel) {
+            cols.relevant(crit.selector, crit.optimize, cols.recommends, rel);
+            if (!crit.optimize) { rel.recommended |= cols.select(crit.selector); }
+        }
+    };
+
+    template <>
+    struct Kernel<Criterion::SUM> {
+        static void apply(Columns &cols, Criterion const &crit, Relevance &rel) {
+            Bitset positive, negative;
+            cols.sign(crit.attrUid1, positive, negative);
+            cols.relevant(crit.selector,  crit.optimize, positive, rel);
+            cols.relevant(crit.selector, !crit.optimize, negative, rel);
+        }
+    };
+
+    // clauses of packages and requests resolved to sorted vectors of package
+    // ids; this is the representation the preprocessing passes work on
+    // (depends and conflicts are only resolved for the selected packages)
+    //
+    // Each depends and recommends clause and each request gets a token in
+    // the order of the packages (recommends first) followed by the install
+    // and upgrade requests; the tokens of a package are the clauses it
+    // occurs in.
+    class ResolvedClauses {
+    public:
+        typedef std::vector<uint32_t> Ids;
+        typedef std::vector<std::unique_ptr<Package>> Packages;
+        // owner of the tokens of requests
+        static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+        template <class Select>
+        ResolvedClauses(Packages const &packages, Dependency::RequestList const &installs, Dependency::RequestList const &upgrades, bool recom, Select select)
+            : depends(packages.size())
+            , recommends(packages.size())
+            , conflicts(packages.size())
+            , neighbors(packages.size())
+            , tokens(packages.size()) {
+            for (auto &pkg : packages) {
+                // NOTE: recommends are dumped independently of the closure
+                if (recom) {
+                    for (EntityList const &clause : pkg->recommends) {
+                        recommends[pkg->id].emplace_back(resolve(clause));
+                        occurs_(pkg->id, false);
+                    }
+                }
+                if (!select(pkg.get())) { continue; }
+                for (EntityList const &clause : pkg->depends) {
+                    depends[pkg->id].emplace_back(resolve(clause));
+                    occurs_(pkg->id, true);
+                }
+                conflicts[pkg->id] = resolve(pkg->conflicts, pkg.get());
+                for (uint32_t id : conflicts[pkg->id]) {
+                    neighbors[pkg->id].push_back(id);
+                    neighbors[id].push_back(pkg->id);
+                }
+            }
+            for (Ids &ids : neighbors) { sort_uniq(ids); }
+            for (Request const &request : installs) {
+                install.emplace_back(resolve(request.requests));
+                occurs_(NONE, false);
+            }
+            for (Request const &request : upgrades) {
+                upgrade.emplace_back(resolve(request.requests));
+                occurs_(NONE, false);
+                // NOTE: versions of upgraded packages are subject to additional
+                //       conflicts, which are not captured by the clauses above
+                upgraded.insert(request.name);
+            }
+        }
+
+        // the packages of a clause (conflicts are resolved without self)
+        Ids const &resolve(EntityList const &clause, Package *self = nullptr) {
+            for (Entity *ent : clause) { ent->addToClause(clause_, self); }
+            ids_.clear();
+            for (Package *pkg : clause_) { ids_.push_back(pkg->id); }
+            sort_uniq(ids_);
+            clause_.clear();
+            return ids_;
+        }
+
+        std::vector<std::vector<Ids>> depends;
+        std::vector<std::vector<Ids>> recommends;
+        // conflicts of each package and the symmetric conflict relation
+        std::vector<Ids>              conflicts;
+        std::vector<Ids>              neighbors;
+        std::vector<Ids>              install;
+        std::vector<Ids>              upgrade;
+        std::vector<Ids>              tokens;
+        // owner of each token and whether it is a depends clause
+        Ids                           owners;
+        std::vector<bool>             dependsClause;
+        std::set<uint32_t>            upgraded;
+
+    private:
+        // adds a token for the last resolved clause
+        void occurs_(uint32_t owner, bool dep) {
+            for (uint32_t id : ids_) { tokens[id].push_back(owners.size()); }
+            owners.push_back(owner);
+            dependsClause.push_back(dep);
+        }
+
+        PackageList clause_;
+        Ids         ids_;
+    };
+
+    constexpr uint32_t ResolvedClauses::NONE;
+
+    // whether all packages of a resolved clause occur in another one
+    bool subset(ResolvedClauses::Ids const &a, ResolvedClauses::Ids const &b) {
+        return a.size() <= b.size() && std::includes(b.begin(), b.end(), a.begin(), a.end());
+    }
+
+    // everything the solver can observe about a package in the closure; two
+    // packages with the same name and equal signatures can be swapped in any
+    // solution without changing its validity or its objective value
+    struct Signature {
+        typedef std::vector<uint32_t>       Ids;
+        typedef std::vector<Ids>            IdsList;
+        typedef std::pair<uint32_t, int64_t> Prop;
+        typedef std::vector<Prop>           PropList;
+
+        Signature() : flags(0), unsafe(false) { }
+        bool operator<(Signature const &sig) const {
+            return
+                std::tie(    flags,     props,     tokens,     depends,     recommends) <
+                std::tie(sig.flags, sig.props, sig.tokens, sig.depends, sig.recommends);
+        }
+        bool operator==(Signature const &sig) const {
+            return
+                std::tie(    flags,     props,     tokens,     depends,     recommends) ==
+                std::tie(sig.flags, sig.props, sig.tokens, sig.depends, sig.recommends);
+        }
+
+        // installed state, inferred attributes, and propagation result
+        uint32_t flags;
+        // values of criteria attributes
+        PropList props;
+        // clauses (of other packages or requests) the package occurs in
+        Ids      tokens;
+        // resolved depends and recommends clauses of the package
+        IdsList  depends;
+        IdsList  recommends;
+        // packages in the closure the package is in conflict with
+        Ids      neighbors;
+        // the package depends on or recommends packages with the same name
+        bool     unsafe;
+    };
+
+    // value of an attribute (0 = missing, 1 = int, 2 = string)
+    Signature::Prop prop(Package const &pkg, uint32_t uid) {
+        Package::IntPropMap::const_iterator it = pkg.intProps.find(uid);
+        if (it != pkg.intProps.end()) { return {1, it->second}; }
+        Package::StringPropMap::const_iterator jt = pkg.stringProps.find(uid);
+        if (jt != pkg.stringProps.end()) { return {2, jt->second}; }
+        return {0, 0};
+    }
+
+    // whether a package belongs to the set selected by a criterion if it is
+    // (not) installed in a solution; packages selected by the removed set
+    // only depend on whether some version with the same name is installed
+    bool member(Package const &pkg, bool in, Criterion::Selector sel) {
+        switch (sel) {
+            case Criterion::SOLUTION:       { return in; }
+            case Criterion::CHANGED:        { return in != pkg.installed; }
+            case Criterion::NEW:            { return in && !pkg.optInstalled; }
+            case Criterion::REMOVED:        { return false; }
+            case Criterion::UP:             { return in && pkg.optGtMaxInstalled; }
+            case Criterion::DOWN:           { return in && pkg.optLtMinInstalled; }
+            case Criterion::INSTALLREQUEST: { return in && pkg.optInInstall; }
+            case Criterion::UPGRADEREQUEST: { return in && pkg.optInUpgrade; }
+            case Criterion::REQUEST:        { return in && (pkg.optInInstall || pkg.optInUpgrade); }
+        }
+        assert(false);
+        return false;
+    }
+
+    // greatest common divisor of the absolute values
+    int64_t gcd(int64_t a, int64_t b) {
+        a = std::abs(a);
+        b = std::abs(b);
+        while (b != 0) { a = std::exchange(b, a % b); }
+        return a;
+    }
+
+    // name of a selector in the facts
+    char const *selectorName(Criterion::Selector sel) {
+        switch (sel) {
+            case Criterion::SOLUTION:       { return "solution"; }
+            case Criterion::NEW:            { return "new"; }
+            case Criterion::REMOVED:        { return "removed"; }
+            case Criterion::CHANGED:        { return "changed"; }
+            case Criterion::UP:             { return "up"; }
+            case Criterion::DOWN:           { return "down"; }
+            case Criterion::INSTALLREQUEST: { return "installrequest"; }
+            case Criterion::UPGRADEREQUEST: { return "upgraderequest"; }
+            case Criterion::REQUEST:        { return "request"; }
+        }
+        assert(false);
+        return "";
+    }
+
+    // evaluates the rules of misc2012.lp deriving the static parts of an
+    // aligned criterion (keyval/4, static/2, remove/2, object/5, statkey/4,
+    // alcount/4, and alchain/5,6) on the elements of its target sets
+    class Aligned {
+    public:
+        static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+        // maximum number of values of a key to use the counter
+        // implementation (see alignCounter in misc2012.lp)
+        static constexpr uint32_t COUNTER = 30;
+        struct Element {
+            Package *pkg;
+            // real clique of the package (or NONE)
+            uint32_t clique;
+            // the package is installed and in the subtracted set
+            bool     sub;
+            // the package has been deleted from the subtracted set
+            bool     del;
+            // all candidates with the package's name are in the same clique
+            bool     rem;
+            int64_t  x;
+            int64_t  y;
+        };
+
+        Aligned(Criterion const &crit) : crit_(crit) { }
+        Criterion const &criterion() const { return crit_; }
+        void add(Element const &elem) { elements_.push_back(elem); }
+
+        void dump(FactWriter &out) {
+            bool removed = crit_.selector == Criterion::REMOVED;
+            auto key = [&](int64_t x) -> FactWriter & {
+                return out << selectorName(crit_.selector) << ",\"" << crit_.attr1 << "\"," << x << ",\"" << crit_.attr2 << "\"";
+            };
+            auto aligned = [&](int64_t x, int64_t y) -> FactWriter & {
+                return out << "aligned(\"" << crit_.attr1 << "\"," << x << ",\"" << crit_.attr2 << "\"," << y << ")";
+            };
+            // elements with the same key and in the same clique are adjacent
+            boost::sort(elements_, [](Element const &a, Element const &b) {
+                return std::tie(a.x, a.clique, a.y, a.pkg->id) < std::tie(b.x, b.clique, b.y, b.pkg->id);
+            });
+            std::vector<int64_t> values, statics, alvalues;
+            std::vector<std::tuple<uint32_t, int64_t, uint32_t>> remvals;
+            std::set<std::pair<int64_t, uint32_t>> removes;
+            for  (auto it = elements_.begin(), ie = elements_.end(); it != ie; ) {
+                int64_t x = it->x;
+                auto jt = std::find_if(it, ie, [x](Element const &elem) { return elem.x != x; });
+                // a key is a oneval key if it has elements outside of cliques, in
+                // the subtracted set, or in a clique with a single value; then it
+                // needs at least two values, otherwise at least two cliques
+                bool one = false;
+                uint32_t cliques = 0;
+                values.clear();
+                for  (auto kt = it; kt != jt; ) {
+                    uint32_t clique = kt->clique;
+                    auto lt = std::find_if(kt, jt, [clique](Element const &elem) { return elem.clique != clique; });
+                    int64_t const *first = nullptr;
+                    bool multi = false;
+                    for  (auto mt = kt; mt != lt; ++mt) {
+                        values.push_back(mt->y);
+                        if (mt->sub || clique == NONE) { one = true; }
+                        else if (!first) { first = &mt->y; }
+                        else if (*first != mt->y) { multi = true; }
+                    }
+                    if (first && clique != NONE) {
+                        ++cliques;
+                        if (!multi) { one = true; }
+                    }
+                    kt = lt;
+                }
+                sort_uniq(values);
+                if (one ? values.size() > 1 : cliques > 1) {
+                    // values of deleted elements and values shared by two
+                    // subtracted elements in a clique are static
+                    statics.clear();
+                    remvals.clear();
+                    for  (auto kt = it; kt != jt; ++kt) {
+                        if (kt->sub && kt->del) { statics.push_back(kt->y); }
+                        if (kt->sub && kt->clique != NONE && (!removed || kt->rem)) {
+                            remvals.emplace_back(kt->clique, kt->y, removed ? kt->pkg->name : kt->pkg->id);
+                        }
+                    }
+                    sort_uniq(remvals);
+                    for  (auto kt = remvals.begin(); kt != remvals.end(); ++kt) {
+                        if (kt + 1 != remvals.end() && std::get<0>(*kt) == std::get<0>(*(kt + 1)) && std::get<1>(*kt) == std::get<1>(*(kt + 1))) {
+                            statics.push_back(std::get<1>(*kt));
+                        }
+                    }
+                    sort_uniq(statics);
+                    alvalues.clear();
+                    removes.clear();
+                    for  (auto kt = it; kt != jt; ++kt) {
+                        if (std::binary_search(statics.begin(), statics.end(), kt->y)) { continue; }
+                        alvalues.push_back(kt->y);
+                        if (removed) { removes.emplace(kt->y, kt->pkg->name); }
+                        else {
+                            out << "object(";
+                            aligned(x, kt->y) << "," << (kt->sub ? "sub" : "sol") << "," << selectorName(crit_.selector) << ",";
+                            out << FactWriter::Symbol{kt->pkg->name} << "," << kt->pkg->version << ").\n";
+                        }
+                    }
+                    for  (auto &rem : removes) {
+                        out << "remove(";
+                        aligned(x, rem.first) << "," << FactWriter::Symbol{rem.second} << ").\n";
+                    }
+                    sort_uniq(alvalues);
+                    if (!alvalues.empty() && !statics.empty()) {
+                        out << "statkey(";
+                        key(x) << ").\n";
+                    }
+                    if (!alvalues.empty() && alvalues.size() <= COUNTER) {
+                        out << "alcount(";
+                        key(x) << ").\n";
+                        for  (auto kt = alvalues.begin(); kt + 1 != alvalues.end(); ++kt) {
+                            out << "alchain(";
+                            key(x) << "," << *kt << "," << *(kt + 1) << ").\n";
+                        }
+                        out << "alchain(";
+                        key(x) << "," << alvalues.back() << ").\n";
+                    }
+                }
+                it = jt;
+            }
+        }
+
+    private:
+        Criterion const     &crit_;
+        std::vector<Element> elements_;
+    };
+
+    constexpr uint32_t Aligned::NONE;
+    constexpr uint32_t Aligned::COUNTER;
+
+    // contribution of a selected package to a count, sum, or notuptodate criterion
+    int64_t weight(Package const &pkg, Criterion const &crit) {
+        switch (crit.measurement) {
+            case Criterion::COUNT:       { return 1; }
+            case Criterion::SUM:         { return prop(pkg, crit.attrUid1).second; }
+            case Criterion::NOTUPTODATE: { return pkg.optMaxVersion ? 0 : 1; }
+            default:                     { break; }
+        }
+        assert(false);
+        return 0;
+    }
 }
 
 //////////////////// Entity /////////////////////////// {{{1
@@ -149,7 +685,10 @@ Package::Package(const Cudf::Package &pkg)
     , optMaxVersion(false)
     , optInInstall(false)
     , optInUpgrade(false)
-    , dfsVisited(false) { }
+    , dfsVisited(false)
+    , fixed(false)
+    , id(0)
+    , scc(nullptr) { }
 
 void Package::doRemove(Dependency *) { }
 
@@ -169,42 +708,6 @@ bool Package::satisfies(Criterion::Selector sel) {
     return false;
 }
 
-Package::Relevant Package::relevant(bool maximize, Criterion::Selector sel) {
-    switch (sel) {
-        case Criterion::SOLUTION:       { return maximize                            ? RELEVANT_SELF : RELEVANT_NONE; }
-        case Criterion::CHANGED:        { return (installed != maximize) && !remove_ ? RELEVANT_SELF : RELEVANT_NONE; }
-        case Criterion::NEW:            { return maximize                            ? RELEVANT_SELF : RELEVANT_NONE; }
-        case Criterion::REMOVED:        { return maximize                            ? RELEVANT_NONE : RELEVANT_EQUAL; }
-        case Criterion::UP:             { return maximize                            ? RELEVANT_SELF : RELEVANT_NONE; }
-        case Criterion::DOWN:           { return maximize                            ? RELEVANT_SELF : RELEVANT_NONE; }
-        case Criterion::INSTALLREQUEST: { return maximize                            ? RELEVANT_SELF : RELEVANT_NONE; }
-        case Criterion::UPGRADEREQUEST: { return maximize                            ? RELEVANT_SELF : RELEVANT_NONE; }
-        case Criterion::REQUEST:        { return maximize                            ? RELEVANT_SELF : RELEVANT_NONE; }
-    }
-    assert(false);
-    return RELEVANT_NONE;
-}
-
-unsigned Package::relevant(Criterion &crit) {
-    if (!satisfies(crit.selector)) { return RELEVANT_NONE; }
-    switch (crit.measurement) {
-        case Criterion::COUNT:            { return                                                      relevant(crit.optimize, crit.selector); }
-        case Criterion::NOTUPTODATE:      { return !optMaxVersion                                     ? relevant(crit.optimize, crit.selector) : RELEVANT_NONE; }
-        case Criterion::ALIGNED:          { return crit.optAligned[getProp(crit.attrUid1)].size() > 1 ? relevant(crit.optimize, crit.selector) : RELEVANT_NONE; }
-        case Criterion::UNSAT_RECOMMENDS: {
-            unsigned rel =  !recommends.empty() ? relevant(crit.optimize, crit.selector) : RELEVANT_NONE;
-            if (!crit.optimize) { rel = rel | RELEVANT_RECOMMENDED; }
-            return rel;
-        }
-        case Criterion::SUM: {
-            int attr = intProps[crit.attrUid1];
-            return attr != 0 ? relevant((attr > 0) == crit.optimize, crit.selector) : RELEVANT_NONE;
-        }
-    }
-    assert(false);
-    return RELEVANT_NONE;
-}
-
 void Package::doAdd(Dependency *dep) {
     if (!dep->addAll()) {
         if (!remove_) {
@@ -227,18 +730,7 @@ uint32_t Package::getProp(uint32_t uid) const {
     return 0;
 }
 
-void Package::dumpAttrs(Dependency *dep, std::ostream &out) {
-    // installed(VP)
-    if (installed) {
-        out << "installed(\"" << dep->string(name) << "\"," << version << ").\n";
-    }
-    // maxversion(VP)
-    if (optMaxVersion) {
-        out << "maxversion(\"" << dep->string(name) << "\"," << version << ").\n";
-    }
-    // additional attributes
-    bool recom = false;
-    std::set<uint32_t> attr;
+void Package::criteriaAttrs(Dependency *dep, bool &recom, std::set<uint32_t> &attr) {
     for (Criterion &crit : dep->criteria.criteria) {
         switch (crit.measurement) {
             case Criterion::UNSAT_RECOMMENDS: {
@@ -261,25 +753,54 @@ void Package::dumpAttrs(Dependency *dep, std::ostream &out) {
             default: { break; }
         }
     }
+}
+
+void Package::attrClauses(Dependency *dep, ClauseList &clauses) {
+    bool recom = false;
+    std::set<uint32_t> attr;
+    criteriaAttrs(dep, recom, attr);
+    if (recom) {
+        for (EntityList &clause : recommends) {
+            clauses.emplace_back();
+            for (Entity *ent : clause) { ent->addToClause(clauses.back()); }
+            sort_uniq(clauses.back());
+        }
+    }
+}
+
+void Package::dumpAttrs(Dependency *dep, FactWriter &out, ConditionList const &conds) {
+    // installed(VP)
+    if (installed) {
+        out << "installed(" << FactWriter::Symbol{name} << "," << version << ").\n";
+    }
+    // maxversion(VP)
+    if (optMaxVersion) {
+        out << "maxversion(" << FactWriter::Symbol{name} << "," << version << ").\n";
+    }
+    // additional attributes
+    bool recom = false;
+    std::set<uint32_t> attr;
+    criteriaAttrs(dep, recom, attr);
     // recommends(VP,D)
     if (recom) {
         typedef std::map<uint32_t, uint32_t> OccurMap;
         OccurMap occur;
-        for (EntityList &clause : recommends) {
-            PackageList pkgClause;
-            for (Entity *ent : clause) { ent->addToClause(pkgClause); }
-            uint32_t condition = dep->addClause(pkgClause, out);
-            occur[condition]++;
+        for (auto &cond : conds) {
+            if (cond.second) { dep->dumpClause(cond.first, out); }
+            occur[cond.first]++;
         }
         for (OccurMap::value_type val : occur) {
-            out << "recommends(\"" << dep->string(name) << "\"," << version << "," << val.first << "," << val.second << ").\n";
+            out << "recommends(" << FactWriter::Symbol{name} << "," << version << "," << val.first << "," << val.second << ").\n";
         }
     }
     // attributes(VP,K,V)
     for (uint32_t uid : attr) {
-        out << "attribute(\"" << dep->string(name) << "\"," << version << ",\"" << dep->string(uid) << "\",";
+        int64_t scale = dep->scale(uid);
         IntPropMap::const_iterator it = intProps.find(uid);
-        if (it != intProps.end()) { out << it->second; }
+        // zero weights of sum criteria can be omitted
+        if (scale > 0 && (it == intProps.end() || it->second == 0)) { continue; }
+        out << "attribute(" << FactWriter::Symbol{name} << "," << version << "," << FactWriter::Quoted{uid} << ",";
+        if (it != intProps.end()) { out << (scale > 0 ? it->second / scale : it->second); }
         else {
             StringPropMap::const_iterator jt = stringProps.find(uid);
             // Note: we do not care for the value at all
@@ -289,28 +810,41 @@ void Package::dumpAttrs(Dependency *dep, std::ostream &out) {
     }
 }
 
-void Package::dumpAsFacts(Dependency *dep, std::ostream &out) {
-    // unit(VP)
-    out << "unit(\"" << dep->string(name) << "\"," << version << "," << (remove_ ? "out" : "in") << ").\n";
+void Package::factClauses(ClauseList &clauses) {
     if (!remove_) {
-        // satisfies(VP,D)
-        // depends(VP,D)
         for (EntityList &clause : depends) {
-            PackageList pkgClause;
-            for (Entity *ent : clause) { ent->addToClause(pkgClause); }
-            uint32_t condition = dep->addClause(pkgClause, out);
-            out << "depends(\"" << dep->string(name) << "\"," << version << "," << condition << ").\n";
+            clauses.emplace_back();
+            for (Entity *ent : clause) { ent->addToClause(clauses.back()); }
+            sort_uniq(clauses.back());
         }
-        // conflicts(VP, D)
         if (!conflicts.empty()) {
-            PackageList pkgClause;
-            for (Entity *ent : conflicts) { ent->addToClause(pkgClause, this); }
-            uint32_t condition = dep->addClause(pkgClause, out);
-            out << "conflict(\"" << dep->string(name) << "\"," << version << "," << condition << ").\n";
+            clauses.emplace_back();
+            for (Entity *ent : conflicts) { ent->addToClause(clauses.back(), this); }
+            sort_uniq(clauses.back());
         }
     }
 }
 
+void Package::dumpAsFacts(Dependency *dep, FactWriter &out, ConditionList const &conds) {
+    // unit(VP)
+    out << "unit(" << FactWriter::Symbol{name} << "," << version << "," << (remove_ ? "out" : "in") << ").\n";
+    // fixed(VP)
+    if (fixed && !remove_) {
+        out << "fixed(" << FactWriter::Symbol{name} << "," << version << ").\n";
+    }
+    // scc(VP, VP)
+    if (scc && scc != this && !remove_) {
+        out << "scc(" << FactWriter::Symbol{name} << "," << version << "," << FactWriter::Symbol{scc->name} << "," << scc->version << ").\n";
+    }
+    // satisfies(VP,D)
+    // depends(VP,D)
+    // conflicts(VP, D)
+    for (size_t i = 0; i < conds.size(); ++i) {
+        if (conds[i].second) { dep->dumpClause(conds[i].first, out); }
+        out << (i < depends.size() ? "depends(" : "conflict(") << FactWriter::Symbol{name} << "," << version << "," << conds[i].first << ").\n";
+    }
+}
+
 void Package::addToClause(PackageList &clause, Package *self) {
     if (!remove_ && this != self) { clause.push_back(this); }
 }
@@ -338,7 +872,7 @@ void Feature::doAdd(Dependency *dep) {
     for (Package *pkg : providedBy) { pkg->add(dep); }
 }
 
-void Feature::dumpAsFacts(Dependency *, std::ostream &) { }
+void Feature::dumpAsFacts(Dependency *, FactWriter &, ConditionList const &) { }
 
 size_t hash_value(const Feature &ftr) {
     size_t seed = 0;
@@ -393,13 +927,13 @@ void Criteria::init(Dependency *dep, CritVec &vec) {
 
 bool ConflictGraph::edgeSort(Package *a, Package *b) {
     // Note: prefer self-conflicts
-    if (a->name != b->name) { return a->name < b->name; }
-    return edges_[a].size() > edges_[b].size();
+    if (a->name != b->name) { return names_[a->name] < names_[b->name]; }
+    if (edges_[a].size() != edges_[b].size()) { return edges_[a].size() > edges_[b].size(); }
+    return a->id < b->id;
 }
 
 bool ConflictGraph::PkgCmp::operator()(Package *a, Package *b) const {
-    if (a->name != b->name) { return a->name < b->name; }
-    return a->version < b->version;
+    return a->id < b->id;
 }
 
 size_t ConflictGraph::PkgHash::operator()(Package *pkg) const {
@@ -425,6 +959,10 @@ void ConflictGraph::init(bool verbose) {
     }
     for (Edges::value_type &out : edges_) {
         out.second.resize(boost::range::unique(boost::range::sort(out.second, PkgCmp())).size());
+        // names are ordered by the position of their first version in the
+        // package list
+        auto res = names_.emplace(out.first->name, out.first->id);
+        if (!res.second) { res.first->second = std::min(res.first->second, out.first->id); }
     }
     components_(verbose);
     cliques_(verbose);
@@ -432,12 +970,17 @@ void ConflictGraph::init(bool verbose) {
 
 void ConflictGraph::components_(bool verbose) {
     uint32_t min = 0, max = 0, sum = 0;
-    for (Edges::value_type &out : edges_) {
-        if (!out.first->dfsVisited) {
+    // NOTE: the roots are visited in the order of the package list to make
+    //       the components independent of the hash map
+    PackageList roots;
+    for (Edges::value_type &out : edges_) { roots.push_back(out.first); }
+    boost::sort(roots, [](Package *a, Package *b) { return a->id < b->id; });
+    for (Package *root : roots) {
+        if (!root->dfsVisited) {
             components.push_back(PackageList());
             PackageList &component = components.back();
-            out.first->dfsVisited = true;
-            component.push_back(out.first);
+            root->dfsVisited = true;
+            component.push_back(root);
             for (PackageList::size_type i = 0; i < component.size(); ++i) {
                 for (Package *pkg : edges_[component[i]]) {
                     if (!pkg->dfsVisited) {
@@ -517,11 +1060,11 @@ void ConflictGraph::cliques_(bool verbose) {
     }
 }
 
-void ConflictGraph::dump(Dependency *dep, std::ostream &out) {
+void ConflictGraph::dump(FactWriter &out) {
     uint32_t index = 0;
     for (PackageList &clique : cliques) {
         for (Package *pkg : clique) {
-            out << "clique(" << index << ",\"" << dep->string(pkg->name) << "\"," << pkg->version << ").\n";
+            out << "clique(" << index << "," << FactWriter::Symbol{pkg->name} << "," << pkg->version << ").\n";
         }
         ++index;
     }
@@ -529,9 +1072,15 @@ void ConflictGraph::dump(Dependency *dep, std::ostream &out) {
 
 //////////////////// Dependency /////////////////////// {{{1
 
-Dependency::Dependency(Criteria::CritVec &crits, bool addAll, bool verbose)
-    : verbose_(verbose)
-    , addAll_(addAll) {
+Dependency::Dependency(Criteria::CritVec &crits, DependencyOptions const &opts)
+    : verbose_(opts.verbose)
+    , addAll_(opts.addAll)
+    , dominance_(opts.dominance)
+    , probing_(opts.probing)
+    , threads_(opts.threads)
+    , precompute_(opts.precompute)
+    , ranges_(opts.ranges)
+    , shuffle_(opts.shuffle) {
     criteria.init(this, crits);
 }
 
@@ -553,6 +1102,7 @@ void Dependency::init(const Cudf::Document &doc) {
     for  (const Cudf::Package &cudfPkg : doc.packages) {
         packages_.emplace_back(std::make_unique<Package>(cudfPkg));
         auto &pkg = packages_.back();
+        pkg->id = packages_.size() - 1;
         entityMap_[pkg->name].push_back(pkg.get());
         for  (const Cudf::PackageRef &provided : cudfPkg.provides) {
             // NOTE: version might be zero here, which is than mapped to the maximum integer value
@@ -590,6 +1140,48 @@ bool Dependency::test_contains(std::string const &name, int32_t version) {
     return false;
 }
 
+bool Dependency::test_fixed(std::string const &name, int32_t version) {
+    for  (auto &pkg : packages_) {
+        if (string(pkg->name) == name && pkg->version == version) { return pkg->fixed; }
+    }
+    return false;
+}
+
+bool Dependency::test_removed(std::string const &name, int32_t version) {
+    for  (auto &pkg : packages_) {
+        if (string(pkg->name) == name && pkg->version == version) { return pkg->remove_; }
+    }
+    return false;
+}
+
+uint32_t Dependency::test_depends(std::string const &name, int32_t version) {
+    for  (auto &pkg : packages_) {
+        if (string(pkg->name) == name && pkg->version == version) { return pkg->depends.size(); }
+    }
+    return 0;
+}
+
+bool Dependency::test_condensed(std::string const &a, int32_t va, std::string const &b, int32_t vb) {
+    Package *sa = nullptr, *sb = nullptr;
+    for  (auto &pkg : packages_) {
+        if (string(pkg->name) == a && pkg->version == va) { sa = pkg->scc; }
+        if (string(pkg->name) == b && pkg->version == vb) { sb = pkg->scc; }
+    }
+    return sa && sa == sb;
+}
+
+bool Dependency::test_symmetric(std::string const &name, int32_t a, int32_t b) {
+    for  (PackageList &sym : symmetries_) {
+        auto match = [&](int32_t version) {
+            return boost::range::find_if(sym, [&](Package *pkg) {
+                return string(pkg->name) == name && pkg->version == version;
+            }) != sym.end();
+        };
+        if (match(a) && match(b)) { return true; }
+    }
+    return false;
+}
+
 void Dependency::rewriteRequests() {
     for  (Entity *ent : remove_) { ent->remove(this); }
     for  (Request &request : upgrade_) {
@@ -638,16 +1230,201 @@ void Dependency::rewriteRequests() {
     }
 }
 
-void Dependency::initClosure() {
+void Dependency::initPropagator(Propagator &prop, bool requests) {
+    ResolvedClauses res(packages_, install_, upgrade_, false, [](Package *pkg) { return !pkg->remove_; });
+    for  (auto &pkg : packages_) {
+        if (pkg->remove_) { prop.assign(pkg->id, Propagator::FALSE); }
+        else {
+            for  (auto &depends : res.depends[pkg->id]) { prop.addDepends(pkg->id, depends); }
+            for  (uint32_t other : res.conflicts[pkg->id]) { prop.addConflict(pkg->id, other); }
+        }
+    }
+    if (!requests) { return; }
+    // NOTE: requests and conflicts are added as in dumpAsFacts
+    for  (auto &request : res.install) { prop.addRequest(request); }
+    for  (RequestList::size_type i = 0; i < upgrade_.size(); ++i) {
+        Request &request = upgrade_[i];
+        prop.addRequest(res.upgrade[i]);
+        for  (Entity *ent : request.requests) {
+            EntityList others;
+            for  (Entity *other : entityMap_[request.name]) {
+                if (ent->version != other->version || ent->allVersions()) { others.push_back(other); }
+            }
+            Propagator::Clause otherIds = res.resolve(others);
+            for  (uint32_t reason : res.resolve({ent})) {
+                for  (uint32_t other : otherIds) { prop.addConflict(reason, other); }
+            }
+        }
+    }
+}
+
+bool Dependency::probe(Propagator &prop, uint32_t &broken) {
+    // failed literals are removed until a fixpoint is reached because
+    // removing packages can make further packages uninstallable
+    for (;;) {
+        Propagator::Clause failed = prop.failed(threads_);
+        if (failed.empty()) { return true; }
+        for  (uint32_t pkg : failed) { prop.assign(pkg, Propagator::FALSE); }
+        broken += failed.size();
+        if (!prop.propagate()) { return false; }
+    }
+}
+
+PackageList Dependency::broken() {
+    Propagator prop(packages_.size());
+    initPropagator(prop, false);
+    uint32_t broken = 0;
+    PackageList ret;
+    // NOTE: without requests the constraints are always satisfiable
+    if (prop.propagate() && probe(prop, broken)) {
+        for  (auto &pkg : packages_) {
+            if (prop.value(pkg->id) == Propagator::FALSE) { ret.push_back(pkg.get()); }
+        }
+    }
+    if (verbose_) {
+        std::cerr << "installability: " << std::endl;
+        std::cerr << "  packages: " << packages_.size() << std::endl;
+        std::cerr << "  broken:   " << ret.size() << std::endl;
+    }
+    return ret;
+}
+
+void Dependency::propagate() {
+    Propagator prop(packages_.size());
+    initPropagator(prop, true);
+    uint32_t fixed = 0, removed = 0, broken = 0;
+    if (prop.propagate() && (!probing_ || probe(prop, broken))) {
+        for  (auto &pkg : packages_) {
+            switch (prop.value(pkg->id)) {
+                case Propagator::TRUE:  { pkg->fixed = true; ++fixed; break; }
+                case Propagator::FALSE: {
+                    if (!pkg->remove_) {
+                        pkg->remove(this);
+                        ++removed;
+                    }
+                    break;
+                }
+                case Propagator::FREE:  { break; }
+            }
+        }
+    }
+    else if (verbose_) {
+        std::cerr << "propagation: requests are unsatisfiable" << std::endl;
+    }
+    if (verbose_) {
+        std::cerr << "propagation: " << std::endl;
+        std::cerr << "  fixed:    " << fixed << std::endl;
+        std::cerr << "  removed:  " << removed << std::endl;
+        std::cerr << "  probed:   " << broken << std::endl;
+    }
+}
+
+void Dependency::dominate() {
+    typedef ResolvedClauses::Ids Ids;
+    if (!dominance_) { return; }
+    bool recom = false;
+    for  (Criterion &crit : criteria.criteria) {
+        if (crit.measurement == Criterion::UNSAT_RECOMMENDS) { recom = true; }
+    }
+    ResolvedClauses res(packages_, install_, upgrade_, recom, [](Package *pkg) { return !pkg->remove_; });
+    auto &depends = res.depends, &recommends = res.recommends;
+    auto &neighbors = res.neighbors, &tokens = res.tokens;
+    for  (auto &clauses : recommends) { boost::sort(clauses); }
+    auto contains = [](Ids const &a, uint32_t id) {
+        return std::binary_search(a.begin(), a.end(), id);
+    };
+    // proof obligations for replacing p by q in a solution for each criterion
+    auto noWorse = [&](Criterion const &crit, Package *q, Package *p) {
+        bool pIn = member(*p, true, crit.selector), pOut = member(*p, false, crit.selector);
+        bool qIn = member(*q, true, crit.selector), qOut = member(*q, false, crit.selector);
+        switch (crit.measurement) {
+            case Criterion::COUNT:
+            case Criterion::SUM:
+            case Criterion::NOTUPTODATE: {
+                // change of the objective if q is (not) already installed
+                int64_t installed = (pOut - pIn) * weight(*p, crit);
+                int64_t added     = installed + (qIn - qOut) * weight(*q, crit);
+                return crit.optimize ? installed >= 0 && added >= 0 : installed <= 0 && added <= 0;
+            }
+            case Criterion::UNSAT_RECOMMENDS: {
+                // NOTE: replacing p by q can only satisfy more recommendations
+                if (crit.optimize) { return false; }
+                return !qIn || qOut || (pIn && std::includes(
+                    recommends[p->id].begin(), recommends[p->id].end(),
+                    recommends[q->id].begin(), recommends[q->id].end()));
+            }
+            case Criterion::ALIGNED: {
+                // NOTE: removing p can only reduce the number of alignment violations
+                if (crit.optimize) { return false; }
+                return !qIn || qOut || (pIn &&
+                    prop(*p, crit.attrUid1) == prop(*q, crit.attrUid1) &&
+                    prop(*p, crit.attrUid2) == prop(*q, crit.attrUid2));
+            }
+        }
+        assert(false);
+        return false;
+    };
+    // whether each solution containing p stays a solution that is not
+    // worse if p is replaced by q
+    auto dominates = [&](Package *q, Package *p) {
+        // each depends clause of q is implied by a depends clause of p
+        for  (Ids const &cq : depends[q->id]) {
+            if (std::none_of(depends[p->id].begin(), depends[p->id].end(), [&](Ids const &cp) {
+                return !contains(cp, p->id) && subset(cp, cq);
+            })) { return false; }
+        }
+        // q only conflicts with packages p conflicts with
+        for  (uint32_t id : neighbors[q->id]) {
+            if (id != p->id && !contains(neighbors[p->id], id)) { return false; }
+        }
+        // all other clauses containing p also contain q
+        auto it = tokens[q->id].begin(), ie = tokens[q->id].end();
+        for  (uint32_t token : tokens[p->id]) {
+            if (res.owners[token] == p->id || (res.owners[token] == q->id && res.dependsClause[token])) { continue; }
+            it = std::lower_bound(it, ie, token);
+            if (it == ie || *it != token) { return false; }
+        }
+        for  (Criterion &crit : criteria.criteria) {
+            if (!noWorse(crit, q, p)) { return false; }
+        }
+        return true;
+    };
+    uint32_t removed = 0;
+    PackageList versions;
+    for  (auto &entry : entityMap_) {
+        if (res.upgraded.find(entry.first) != res.upgraded.end()) { continue; }
+        for  (Entity *ent : entry.second) {
+            Package *pkg = dynamic_cast<Package*>(ent);
+            if (pkg && !pkg->remove_) { versions.push_back(pkg); }
+        }
+        // NOTE: prefer removing smaller versions
+        boost::sort(versions, [](Package *a, Package *b) { return a->version < b->version; });
+        for  (Package *p : versions) {
+            if (p->installed || p->fixed) { continue; }
+            for  (Package *q : versions) {
+                if (q != p && !q->remove_ && dominates(q, p)) {
+                    p->remove(this);
+                    ++removed;
+                    break;
+                }
+            }
+        }
+        versions.clear();
+    }
+    if (verbose_) {
+        std::cerr << "dominance: " << std::endl;
+        std::cerr << "  removed:  " << removed << std::endl;
+    }
+}
+
+void Dependency::initAttributes() {
     for  (Request &request : upgrade_) {
-        request.add(this);
         for  (Entity *ent : request.requests) {
             Package *pkg = dynamic_cast<Package*>(ent);
             if (pkg) { pkg->optInUpgrade = true; }
         }
     }
     for  (Request &request : install_) {
-        request.add(this);
         for  (Entity *ent : request.requests) {
             Package *pkg = dynamic_cast<Package*>(ent);
             if (pkg) { pkg->optInInstall = true; }
@@ -677,43 +1454,123 @@ void Dependency::initClosure() {
                 pkg->optInstalled      = installed;
                 pkg->optLtMinInstalled = minInstalled && pkg->version < minInstalled->version;
                 pkg->optGtMaxInstalled = maxInstalled && pkg->version > maxInstalled->version;
-                for  (Criterion &crit : criteria.criteria) {
-                    if (crit.measurement == Criterion::ALIGNED) {
-                        // NOTE: a pair<uint32_t,bool> as value would be sufficient
-                        crit.optAligned[pkg->getProp(crit.attrUid1)].insert(pkg->getProp(crit.attrUid2));
-                    }
-                }
             }
         }
     }
-    for  (EntityList &list : entityMap_ | boost::adaptors::map_values) {
-        for  (Entity *ent : list) {
-            for  (Criterion &crit : criteria.criteria) {
-                Package *pkg = dynamic_cast<Package*>(ent);
-                if (pkg) {
-                    unsigned rel = pkg->relevant(crit);
-                    if (rel & Package::RELEVANT_SELF) {
-                        pkg->add(this);
-                    }
-                    if (rel & Package::RELEVANT_RECOMMENDED) {
-                        for  (EntityList &clause : pkg->recommends) {
-                            for  (Entity *ent : clause) {
-                                if (!ent->remove_) { ent->add(this); }
-                            }
-                        }
-                    }
-                    if (rel & Package::RELEVANT_EQUAL) {
-                        for  (Entity *other : entityMap_[pkg->name]) {
-                            if (!other->remove_) { other->add(this); }
+}
+
+void Dependency::initClosure() {
+    for  (Request &request : upgrade_) { request.add(this); }
+    for  (Request &request : install_) { request.add(this); }
+    markRelevant();
+}
+
+void Dependency::markRelevant() {
+    Columns cols(packages_);
+    Relevance rel(packages_.size());
+    for  (Criterion &crit : criteria.criteria) {
+        switch (crit.measurement) {
+            case Criterion::COUNT:            { Kernel<Criterion::COUNT>::apply(cols, crit, rel); break; }
+            case Criterion::SUM:              { Kernel<Criterion::SUM>::apply(cols, crit, rel); break; }
+            case Criterion::NOTUPTODATE:      { Kernel<Criterion::NOTUPTODATE>::apply(cols, crit, rel); break; }
+            case Criterion::UNSAT_RECOMMENDS: { Kernel<Criterion::UNSAT_RECOMMENDS>::apply(cols, crit, rel); break; }
+            case Criterion::ALIGNED:          { Kernel<Criterion::ALIGNED>::apply(cols, crit, rel); break; }
+        }
+    }
+    Bitset any = rel.self | rel.equal | rel.recommended;
+    for  (Bitset::size_type i = any.find_first(); i != Bitset::npos; i = any.find_next(i)) {
+        Package *pkg = packages_[i].get();
+        if (rel.self[i]) {
+            pkg->add(this);
+        }
+        if (rel.recommended[i]) {
+            for  (EntityList &clause : pkg->recommends) {
+                for  (Entity *ent : clause) {
+                    if (!ent->remove_) { ent->add(this); }
+                }
+            }
+        }
+        if (rel.equal[i]) {
+            for  (Entity *other : entityMap_[pkg->name]) {
+                if (!other->remove_) { other->add(this); }
+            }
+        }
+    }
+}
+
+void Dependency::reorder() {
+    // names are ordered breadth-first along the dependencies of their
+    // versions starting from the requested names; the successors of a name
+    // and the names that are not reached (which are used as further roots)
+    // are visited in lexicographic order
+    std::vector<uint32_t> names, succ;
+    std::vector<bool> seen(strings_.size(), false);
+    auto visit = [&](uint32_t name) {
+        if (!seen[name]) {
+            seen[name] = true;
+            names.push_back(name);
+        }
+    };
+    auto versions = [&](uint32_t name) {
+        PackageList ret;
+        auto it = entityMap_.find(name);
+        if (it == entityMap_.end()) { return ret; }
+        for  (Entity *ent : it->second) {
+            Package *pkg = dynamic_cast<Package*>(ent);
+            if (pkg) { ret.push_back(pkg); }
+        }
+        boost::sort(ret, [](Package *a, Package *b) { return a->version < b->version; });
+        return ret;
+    };
+    std::vector<uint32_t> roots;
+    for  (Request &request : install_) { roots.push_back(request.name); }
+    for  (Request &request : upgrade_) { roots.push_back(request.name); }
+    for  (Entity *ent : remove_) { roots.push_back(ent->name); }
+    std::vector<uint32_t> rest;
+    for  (auto &pkg : packages_) { rest.push_back(pkg->name); }
+    sort_uniq(rest);
+    boost::sort(rest, [this](uint32_t a, uint32_t b) { return string(a) < string(b); });
+    roots.insert(roots.end(), rest.begin(), rest.end());
+    PackageList order;
+    size_t head = 0;
+    for  (uint32_t root : roots) {
+        for  (visit(root); head < names.size(); ++head) {
+            for  (Package *pkg : versions(names[head])) {
+                order.push_back(pkg);
+                for  (EntityList &clause : pkg->depends) {
+                    for  (Entity *ent : clause) {
+                        Feature *ftr = dynamic_cast<Feature*>(ent);
+                        if (!ftr) { succ.push_back(ent->name); }
+                        else {
+                            for  (Package *provider : ftr->providedBy) { succ.push_back(provider->name); }
                         }
                     }
                 }
             }
+            sort_uniq(succ);
+            boost::sort(succ, [this](uint32_t a, uint32_t b) { return string(a) < string(b); });
+            for  (uint32_t name : succ) { visit(name); }
+            succ.clear();
         }
     }
+    assert(order.size() == packages_.size());
+    // for robustness testing, the order can be shuffled; note that the
+    // random numbers of std::mt19937 (unlike the distributions) are the same
+    // on all platforms
+    if (shuffle_ != 0) {
+        std::mt19937 rng(shuffle_);
+        for  (size_t i = order.size(); i > 1; --i) { std::swap(order[i - 1], order[rng() % i]); }
+    }
+    PackageSet packages;
+    for  (Package *pkg : order) {
+        packages.emplace_back(std::move(packages_[pkg->id]));
+    }
+    packages_.swap(packages);
+    for  (uint32_t id = 0; id < packages_.size(); ++id) { packages_[id]->id = id; }
 }
 
 void Dependency::closure() {
+    reorder();
     rewriteRequests();
     if (addAll_) {
         for  (EntityList &list : entityMap_ | boost::adaptors::map_values) {
@@ -733,8 +1590,23 @@ void Dependency::closure() {
             }
         }
     }
-    else { initClosure(); }
+    else {
+        propagate();
+        initAttributes();
+        dominate();
+        initClosure();
+    }
     for(PackageList::size_type i = 0; i < closure_.size(); i++) { closure_[i]->doAdd(this); }
+    if (!addAll_) {
+        subsume();
+        condense();
+    }
+    // packages in the closure are ordered like the package list (features
+    // are not written and put last)
+    std::stable_sort(closure_.begin(), closure_.end(), [](Entity *a, Entity *b) {
+        Package *pa = dynamic_cast<Package*>(a), *pb = dynamic_cast<Package*>(b);
+        return pa && (!pb || pa->id < pb->id);
+    });
     if (verbose_) {
         std::cerr << "sizes: " << std::endl;
         std::cerr << "  features: " << features_.size() << std::endl;
@@ -743,16 +1615,394 @@ void Dependency::closure() {
     }
 }
 
-uint32_t Dependency::addClause(PackageList &clause, std::ostream &out) {
+void Dependency::subsume() {
+    typedef ResolvedClauses::Ids Ids;
+    // resolved depends clauses of packages in the closure
+    ResolvedClauses res(packages_, install_, upgrade_, false, [](Package *pkg) { return pkg->visited && !pkg->remove_; });
+    auto &depends = res.depends;
+    std::vector<std::vector<bool>> redundant(packages_.size());
+    uint32_t clauses = 0, removed = 0;
+    for  (auto &pkg : packages_) {
+        redundant[pkg->id].resize(depends[pkg->id].size(), false);
+        clauses += depends[pkg->id].size();
+    }
+    // packages that have to be installed together with a package because of
+    // unit clauses; note that unit clauses are never removed below
+    Ids forced, stamp(packages_.size(), 0);
+    auto force = [&](uint32_t id) {
+        forced.clear();
+        forced.push_back(id);
+        stamp[id] = id + 1;
+        for  (Ids::size_type i = 0; i < forced.size(); ++i) {
+            for  (Ids const &dep : depends[forced[i]]) {
+                if (dep.size() == 1 && stamp[dep.front()] != id + 1) {
+                    stamp[dep.front()] = id + 1;
+                    forced.push_back(dep.front());
+                }
+            }
+        }
+    };
+    for  (auto &pkg : packages_) {
+        std::vector<Ids> &own = depends[pkg->id];
+        if (std::none_of(own.begin(), own.end(), [](Ids const &dep) { return dep.size() > 1; })) { continue; }
+        force(pkg->id);
+        for  (std::vector<Ids>::size_type i = 0; i < own.size(); ++i) {
+            Ids const &dep = own[i];
+            if (dep.size() < 2) { continue; }
+            // the clause is satisfied by a package that has to be installed anyway
+            bool implied = std::any_of(dep.begin(), dep.end(), [&](uint32_t id) { return stamp[id] == pkg->id + 1; });
+            // the clause is implied by another (remaining) clause of a forced package
+            for  (auto it = forced.begin(), ie = forced.end(); !implied && it != ie; ++it) {
+                std::vector<Ids> &other = depends[*it];
+                for  (std::vector<Ids>::size_type j = 0; !implied && j < other.size(); ++j) {
+                    implied = (*it != pkg->id || j != i) && !redundant[*it][j] && subset(other[j], dep);
+                }
+            }
+            if (implied) {
+                redundant[pkg->id][i] = true;
+                ++removed;
+            }
+        }
+        EntityFormula kept;
+        for  (EntityFormula::size_type i = 0; i < pkg->depends.size(); ++i) {
+            if (!redundant[pkg->id][i]) { kept.emplace_back(std::move(pkg->depends[i])); }
+        }
+        std::swap(pkg->depends, kept);
+    }
+    if (verbose_) {
+        std::cerr << "subsumption: " << std::endl;
+        std::cerr << "  clauses:  " << clauses << std::endl;
+        std::cerr << "  removed:  " << removed << std::endl;
+    }
+}
+
+void Dependency::condense() {
+    typedef ResolvedClauses::Ids Ids;
+    uint32_t const none = std::numeric_limits<uint32_t>::max();
+    // edges along unit depends clauses between packages in the closure
+    ResolvedClauses res(packages_, install_, upgrade_, false, [](Package *pkg) { return pkg->visited && !pkg->remove_; });
+    std::vector<Ids> edges(packages_.size());
+    for  (auto &pkg : packages_) {
+        for  (Ids const &dep : res.depends[pkg->id]) {
+            if (dep.size() == 1 && dep.front() != pkg->id) { edges[pkg->id].push_back(dep.front()); }
+        }
+    }
+    // iterative version of Tarjan's algorithm
+    Ids index(packages_.size(), none), low(packages_.size(), 0), stack;
+    std::vector<bool> onStack(packages_.size(), false);
+    std::vector<std::pair<uint32_t, uint32_t>> dfs;
+    uint32_t next = 0, components = 0, condensed = 0;
+    for  (uint32_t root = 0; root < packages_.size(); ++root) {
+        if (edges[root].empty() || index[root] != none) { continue; }
+        dfs.emplace_back(root, 0);
+        index[root] = low[root] = next++;
+        stack.push_back(root);
+        onStack[root] = true;
+        while (!dfs.empty()) {
+            uint32_t id = dfs.back().first;
+            uint32_t &edge = dfs.back().second;
+            if (edge < edges[id].size()) {
+                uint32_t succ = edges[id][edge++];
+                if (index[succ] == none) {
+                    index[succ] = low[succ] = next++;
+                    stack.push_back(succ);
+                    onStack[succ] = true;
+                    dfs.emplace_back(succ, 0);
+                }
+                else if (onStack[succ]) { low[id] = std::min(low[id], index[succ]); }
+                continue;
+            }
+            dfs.pop_back();
+            if (!dfs.empty()) { low[dfs.back().first] = std::min(low[dfs.back().first], low[id]); }
+            if (low[id] == index[id]) {
+                // the component is on top of the stack so searching from the
+                // back only visits its packages
+                auto it = std::prev(std::find(stack.rbegin(), stack.rend(), id).base());
+                if (stack.end() - it > 1) {
+                    // NOTE: the package with the smallest id represents the component
+                    Package *rep = packages_[*std::min_element(it, stack.end())].get();
+                    for  (auto jt = it; jt != stack.end(); ++jt) { packages_[*jt]->scc = rep; }
+                    condensed += stack.end() - it;
+                    ++components;
+                }
+                for  (auto jt = it; jt != stack.end(); ++jt) { onStack[*jt] = false; }
+                stack.erase(it, stack.end());
+            }
+        }
+    }
+    if (verbose_) {
+        std::cerr << "condensation: " << std::endl;
+        std::cerr << "  components: " << components << std::endl;
+        std::cerr << "  packages:   " << condensed << std::endl;
+    }
+}
+
+void Dependency::dumpProgram(GroundProgram &prg, bool changes) {
+    typedef GroundProgram::Atom Atom;
+    typedef GroundProgram::Literal Literal;
+    typedef GroundProgram::LitVec LitVec;
+    // in(P,V)
+    std::vector<Atom> in(packages_.size(), 0);
+    for  (Entity *ent : closure_) {
+        Package *pkg = dynamic_cast<Package*>(ent);
+        if (pkg && !pkg->remove_) { in[pkg->id] = prg.atom(); }
+    }
+    for  (auto &pkg : packages_) {
+        Atom atom = in[pkg->id];
+        if (atom == 0) { continue; }
+        bool scc = pkg->scc && pkg->scc != pkg.get();
+        if (pkg->fixed) { prg.rule({atom}, {}); }
+        if (!scc)                     { prg.rule({atom}, {}, true); }
+        else if (in[pkg->scc->id] != 0) { prg.rule({atom}, {static_cast<Literal>(in[pkg->scc->id])}); }
+        // with changes, in(P,V) is only shown for packages that are not
+        // installed and out(P,V) for installed packages (see the output
+        // projection in the encoding)
+        std::string args = "(\"" + string(pkg->name) + "\"," + std::to_string(pkg->version) + ")";
+        if (!changes || !pkg->installed) { prg.output("in" + args, {static_cast<Literal>(atom)}); }
+        else                             { prg.output("out" + args, {-static_cast<Literal>(atom)}); }
+    }
+    if (changes) {
+        for  (auto &pkg : packages_) {
+            if (pkg->installed && in[pkg->id] == 0) {
+                prg.output("out(\"" + string(pkg->name) + "\"," + std::to_string(pkg->version) + ")", {});
+            }
+        }
+    }
+    for  (PackageList &sym : symmetries_) {
+        for  (auto it = sym.begin() + 1, ie = sym.end(); it != ie; ++it) {
+            Literal lit = in[(*it)->id], prev = in[(*(it - 1))->id];
+            if (lit == 0)       { continue; }
+            else if (prev == 0) { prg.rule({}, {lit}); }
+            else                { prg.rule({}, {lit, -prev}); }
+        }
+    }
+    // satisfied(D)
+    std::vector<Atom> satisfied;
+    auto condition = [&](PackageList &clause) -> Atom {
+        sort_uniq(clause);
+        std::pair<uint32_t, bool> res = clauses_.insert(clause);
+        if (res.second) {
+            satisfied.resize(res.first + 1, 0);
+            Atom atom = satisfied[res.first] = prg.atom();
+            for  (Package *pkg : clause) {
+                if (in[pkg->id] != 0) { prg.rule({atom}, {static_cast<Literal>(in[pkg->id])}); }
+            }
+        }
+        return satisfied[res.first];
+    };
+    for  (Entity *ent : closure_) {
+        Package *pkg = dynamic_cast<Package*>(ent);
+        if (!pkg || pkg->remove_) { continue; }
+        Literal lit = in[pkg->id];
+        for (EntityList &clause : pkg->depends) {
+            PackageList pkgClause;
+            for (Entity *ent : clause) { ent->addToClause(pkgClause); }
+            prg.rule({}, {lit, -static_cast<Literal>(condition(pkgClause))});
+        }
+        if (!pkg->conflicts.empty()) {
+            PackageList pkgClause;
+            for (Entity *ent : pkg->conflicts) { ent->addToClause(pkgClause, pkg); }
+            prg.rule({}, {lit, static_cast<Literal>(condition(pkgClause))});
+        }
+    }
+    for  (Request &request : install_) {
+        PackageList pkgClause;
+        for  (Entity *ent : request.requests) { ent->addToClause(pkgClause); }
+        prg.rule({}, {-static_cast<Literal>(condition(pkgClause))});
+    }
+    for  (Request &request : upgrade_) {
+        PackageList pkgClause;
+        for  (Entity *ent : request.requests) { ent->addToClause(pkgClause); }
+        prg.rule({}, {-static_cast<Literal>(condition(pkgClause))});
+        for  (Entity *ent : request.requests) {
+            PackageList pkgClause;
+            for  (Entity *other : entityMap_[request.name]) {
+                if (ent->version != other->version || ent->allVersions()) { other->addToClause(pkgClause); }
+            }
+            Literal lit = condition(pkgClause);
+            PackageList pkgReason;
+            ent->addToClause(pkgReason);
+            sort_uniq_ptr(pkgReason);
+            for  (Package *pkg : pkgReason) {
+                if (in[pkg->id] != 0) { prg.rule({}, {static_cast<Literal>(in[pkg->id]), lit}); }
+            }
+        }
+    }
+    // in(P) for packages selected by the removed set
+    std::map<uint32_t, Literal> removed;
+    auto notIn = [&](Package *pkg) -> Literal {
+        auto res = removed.emplace(pkg->name, 0);
+        if (res.second) {
+            LitVec versions;
+            for  (Entity *ent : entityMap_[pkg->name]) {
+                Package *other = dynamic_cast<Package*>(ent);
+                if (other && in[other->id] != 0) { versions.emplace_back(in[other->id]); }
+            }
+            boost::sort(versions);
+            if (versions.empty())          { res.first->second = prg.top(); }
+            else if (versions.size() == 1) { res.first->second = -versions.front(); }
+            else {
+                Atom atom = prg.atom();
+                for  (Literal lit : versions) { prg.rule({atom}, {lit}); }
+                res.first->second = -static_cast<Literal>(atom);
+            }
+        }
+        return res.first->second;
+    };
+    // set(S,P,V) as a single literal or 0 if the package cannot be in the set
+    auto member = [&](Package *pkg, Criterion::Selector sel) -> Literal {
+        Literal lit = in[pkg->id];
+        switch (sel) {
+            case Criterion::SOLUTION:       { return lit; }
+            case Criterion::CHANGED:        { return !pkg->installed ? lit : lit != 0 ? -lit : prg.top(); }
+            case Criterion::NEW:            { return !pkg->optInstalled ? lit : 0; }
+            case Criterion::REMOVED:        { return pkg->installed ? notIn(pkg) : 0; }
+            case Criterion::UP:             { return pkg->optGtMaxInstalled ? lit : 0; }
+            case Criterion::DOWN:           { return pkg->optLtMinInstalled ? lit : 0; }
+            case Criterion::INSTALLREQUEST: { return pkg->optInInstall ? lit : 0; }
+            case Criterion::UPGRADEREQUEST: { return pkg->optInUpgrade ? lit : 0; }
+            case Criterion::REQUEST:        { return pkg->optInInstall || pkg->optInUpgrade ? lit : 0; }
+        }
+        assert(false);
+        return 0;
+    };
+    // atom holding if one of the literals holds
+    auto disjunction = [&](LitVec const &lits) -> Literal {
+        if (lits.size() == 1) { return lits.front(); }
+        Atom atom = prg.atom();
+        for  (Literal lit : lits) { prg.rule({atom}, {lit}); }
+        return atom;
+    };
+    // criteria
+    int priority = criteria.criteria.size();
+    for  (Criterion &crit : criteria.criteria) {
+        GroundProgram::WeightLitVec lits;
+        std::map<std::pair<int64_t, int64_t>, LitVec> pairs;
+        std::map<int64_t, LitVec> keys;
+        for  (auto &pkg : packages_) {
+            Literal lit = member(pkg.get(), crit.selector);
+            if (lit == 0) { continue; }
+            switch (crit.measurement) {
+                case Criterion::COUNT: {
+                    lits.emplace_back(lit, 1);
+                    break;
+                }
+                case Criterion::SUM: {
+                    int64_t value = prop(*pkg, crit.attrUid1).second;
+                    if (value != 0) { lits.emplace_back(lit, value); }
+                    break;
+                }
+                case Criterion::NOTUPTODATE: {
+                    if (!pkg->optMaxVersion) { lits.emplace_back(lit, 1); }
+                    break;
+                }
+                case Criterion::UNSAT_RECOMMENDS: {
+                    std::map<Atom, int64_t> occur;
+                    for (EntityList &clause : pkg->recommends) {
+                        PackageList pkgClause;
+                        for (Entity *ent : clause) { ent->addToClause(pkgClause); }
+                        occur[condition(pkgClause)]++;
+                    }
+                    for (auto &val : occur) {
+                        Atom atom = prg.atom();
+                        prg.rule({atom}, {lit, -static_cast<Literal>(val.first)});
+                        lits.emplace_back(atom, val.second);
+                    }
+                    break;
+                }
+                case Criterion::ALIGNED: {
+                    auto x = prop(*pkg, crit.attrUid1), y = prop(*pkg, crit.attrUid2);
+                    if (x.first != 0 && y.first != 0) {
+                        pairs[{x.second, y.second}].emplace_back(lit);
+                        keys[x.second].emplace_back(lit);
+                    }
+                    break;
+                }
+            }
+        }
+        for  (auto &pair : pairs) { lits.emplace_back(disjunction(pair.second), 1); }
+        for  (auto &key : keys)   { lits.emplace_back(disjunction(key.second), -1); }
+        if (crit.optimize) {
+            for  (auto &lit : lits) { lit.second = -lit.second; }
+        }
+        prg.minimize(priority, lits);
+        --priority;
+    }
+    prg.end();
+    if (verbose_) {
+        std::cerr << "program: " << std::endl;
+        std::cerr << "  atoms:    " << prg.atoms() << std::endl;
+        std::cerr << "  rules:    " << prg.rules() << std::endl;
+    }
+}
+
+uint32_t Dependency::addClause(PackageList &clause, FactWriter &out) {
     sort_uniq(clause);
-    std::pair<ClauseMap::iterator,bool> res = clauses_.insert(ClauseMap::value_type(clause, 0));
+    std::pair<uint32_t, bool> res = insertClause(clause, ClausePool::fingerprint(clause));
+    if (res.second) { dumpClause(res.first, out); }
+    return res.first;
+}
+
+std::pair<uint32_t, bool> Dependency::insertClause(PackageList const &clause, uint64_t fingerprint) {
+    std::pair<uint32_t, bool> res = clauses_.insert(clause, fingerprint);
     if (res.second) {
-        res.first->second = clauses_.size();
-        for  (Package *pkg : clause) {
-            out << "satisfies(\"" << string(pkg->name) << "\"," << pkg->version << "," << res.first->second << ").\n";
+        for  (Package *pkg : clause) { relate(pkg, SAT, res.first); }
+    }
+    return res;
+}
+
+void Dependency::dumpClause(uint32_t condition, FactWriter &out) {
+    auto clause = clauses_.clause(condition);
+    if (!ranges_) {
+        for  (auto it = clause.first; it != clause.second; ++it) {
+            out << "satisfies(" << FactWriter::Symbol{(*it)->name} << "," << (*it)->version << "," << condition << ").\n";
         }
     }
-    return res.first->second;
+    else {
+        // runs of consecutive versions of a name are written as ranges
+        PackageList sorted(clause.first, clause.second);
+        std::sort(sorted.begin(), sorted.end(), [](Package *a, Package *b) {
+            return a->name != b->name ? a->name < b->name : a->version < b->version;
+        });
+        for  (auto it = sorted.begin(), ie = sorted.end(); it != ie; ) {
+            auto jt = it;
+            while (jt + 1 != ie && successors_[(*jt)->id] == *(jt + 1)) { ++jt; }
+            if (it == jt) {
+                out << "satisfies(" << FactWriter::Symbol{(*it)->name} << "," << (*it)->version << "," << condition << ").\n";
+            }
+            else {
+                out << "satisfies(" << FactWriter::Symbol{(*it)->name} << "," << (*it)->version << "," << (*jt)->version << "," << condition << ").\n";
+            }
+            it = jt + 1;
+        }
+    }
+}
+
+void Dependency::dumpInstalled(std::ostream &out) {
+    std::vector<bool> candidate(packages_.size(), false);
+    for  (Entity *ent : closure_) {
+        Package *pkg = dynamic_cast<Package*>(ent);
+        if (pkg && !pkg->remove_) { candidate[pkg->id] = true; }
+    }
+    for  (auto &pkg : packages_) {
+        if (pkg->installed) { out << string(pkg->name) << " " << pkg->version << " " << candidate[pkg->id] << "\n"; }
+    }
+}
+
+void Dependency::initSuccessors() {
+    // only packages with unit(P,V,in) facts may appear in between the bounds
+    // of a range
+    std::map<uint32_t, PackageList> versions;
+    for  (Entity *ent : closure_) {
+        Package *pkg = dynamic_cast<Package*>(ent);
+        if (pkg && !pkg->remove_) { versions[pkg->name].emplace_back(pkg); }
+    }
+    successors_.assign(packages_.size(), nullptr);
+    for  (auto &name : versions) {
+        PackageList &pkgs = name.second;
+        std::sort(pkgs.begin(), pkgs.end(), [](Package *a, Package *b) { return a->version < b->version; });
+        for  (auto it = pkgs.begin(), ie = pkgs.end(); it + 1 < ie; ++it) { successors_[(*it)->id] = *(it + 1); }
+    }
 }
 
 bool Dependency::addAll() const {
@@ -766,15 +2016,588 @@ void Dependency::conflicts() {
     conflictGraph_.init(verbose_);
 }
 
-void Dependency::dumpAsFacts(std::ostream &out) {
+void Dependency::symmetries() {
+    if (addAll_) { return; }
+    std::vector<Signature> sigs(packages_.size());
+    auto inClosure = [](Package *pkg) { return pkg->visited && !pkg->remove_; };
+    ResolvedClauses res(packages_, install_, upgrade_, true, inClosure);
+    // inferred attributes only matter if some criterion refers to them
+    uint32_t mask = 3;
+    for  (Criterion &crit : criteria.criteria) {
+        if (crit.measurement == Criterion::NOTUPTODATE) { mask |= 1 << 2; }
+        switch (crit.selector) {
+            case Criterion::UP:             { mask |= 1 << 3; break; }
+            case Criterion::DOWN:           { mask |= 1 << 4; break; }
+            case Criterion::INSTALLREQUEST: { mask |= 1 << 5; break; }
+            case Criterion::UPGRADEREQUEST: { mask |= 1 << 6; break; }
+            case Criterion::REQUEST:        { mask |= 3 << 5; break; }
+            default:                        { break; }
+        }
+    }
+    for  (auto &pkg : packages_) {
+        Signature &sig = sigs[pkg->id];
+        sig.flags = mask & (
+            pkg->installed         << 0 |
+            pkg->fixed             << 1 |
+            pkg->optMaxVersion     << 2 |
+            pkg->optGtMaxInstalled << 3 |
+            pkg->optLtMinInstalled << 4 |
+            pkg->optInInstall      << 5 |
+            pkg->optInUpgrade      << 6);
+        for  (uint32_t uid : criteria.optProps) { sig.props.emplace_back(prop(*pkg, uid)); }
+        for  (auto *clauses : {&res.recommends[pkg->id], &res.depends[pkg->id]}) {
+            for  (auto &ids : *clauses) {
+                for  (uint32_t id : ids) {
+                    if (packages_[id]->name == pkg->name) { sig.unsafe = true; }
+                }
+            }
+        }
+        sig.tokens = std::move(res.tokens[pkg->id]);
+        sig.recommends = std::move(res.recommends[pkg->id]);
+        boost::sort(sig.recommends);
+        if (inClosure(pkg.get())) {
+            sig.depends = std::move(res.depends[pkg->id]);
+            sort_uniq(sig.depends);
+            for  (uint32_t id : res.neighbors[pkg->id]) {
+                if (inClosure(packages_[id].get())) { sig.neighbors.push_back(id); }
+            }
+        }
+    }
+    // group candidates with equal signatures by name
+    PackageList candidates;
+    for  (auto &pkg : packages_) {
+        if (inClosure(pkg.get()) && !sigs[pkg->id].unsafe && res.upgraded.find(pkg->name) == res.upgraded.end()) {
+            candidates.push_back(pkg.get());
+        }
+    }
+    auto sigLess = [&](Package *a, Package *b) {
+        if (a->name != b->name) { return a->name < b->name; }
+        return sigs[a->id] < sigs[b->id];
+    };
+    auto sigEqual = [&](Package *a, Package *b) {
+        return a->name == b->name && sigs[a->id] == sigs[b->id];
+    };
+    // conflict neighbors including (adjacent) or excluding (non-adjacent) the package itself
+    auto closed = [&](Package *pkg) {
+        Signature::Ids ids = sigs[pkg->id].neighbors;
+        ids.insert(std::lower_bound(ids.begin(), ids.end(), pkg->id), pkg->id);
+        return ids;
+    };
+    auto open = [&](Package *pkg) { return sigs[pkg->id].neighbors; };
+    auto group = [&](PackageList &run, std::function<Signature::Ids(Package*)> key) {
+        std::vector<std::pair<Signature::Ids, Package*>> keyed;
+        for  (Package *pkg : run) { keyed.emplace_back(key(pkg), pkg); }
+        boost::sort(keyed);
+        PackageList rest;
+        for  (auto it = keyed.begin(), ie = keyed.end(); it != ie; ) {
+            auto jt = std::find_if(it, ie, [it](std::pair<Signature::Ids, Package*> const &x) { return x.first != it->first; });
+            if (jt - it > 1) {
+                symmetries_.emplace_back();
+                for  (; it != jt; ++it) { symmetries_.back().push_back(it->second); }
+            }
+            else { rest.push_back(it->second); }
+            it = jt;
+        }
+        std::swap(run, rest);
+    };
+    boost::sort(candidates, sigLess);
+    uint32_t grouped = 0;
+    for  (auto it = candidates.begin(), ie = candidates.end(); it != ie; ) {
+        auto jt = std::find_if(it, ie, [&](Package *pkg) { return !sigEqual(*it, pkg); });
+        if (jt - it > 1) {
+            PackageList run(it, jt);
+            group(run, closed);
+            group(run, open);
+        }
+        it = jt;
+    }
+    for  (PackageList &sym : symmetries_) {
+        // NOTE: prefer larger versions
+        boost::sort(sym, [](Package *a, Package *b) { return a->version > b->version; });
+        grouped += sym.size();
+    }
+    if (verbose_) {
+        std::cerr << "symmetries: " << symmetries_.size() << std::endl;
+        std::cerr << "  packages: " << grouped << std::endl;
+    }
+}
+
+void Dependency::relate(Package *pkg, Relation rel, uint32_t clause) {
+    if (precompute_) { relations_[pkg->id].push_back(rel << 32 | clause); }
+}
+
+void Dependency::dumpObjectives(FactWriter &out) {
+    typedef std::map<uint32_t, int64_t> Weights;
+    // the criteria per selector (without duplicates)
+    std::map<Criterion::Selector, std::vector<Criterion const*>> targets;
+    for  (Criterion &crit : criteria.criteria) {
+        auto &crits = targets[crit.selector];
+        bool duplicate = boost::range::find_if(crits, [&](Criterion const *other) {
+            return
+                std::tie(crit.measurement, crit.attrUid1, crit.attrUid2) ==
+                std::tie(other->measurement, other->attrUid1, other->attrUid2);
+        }) != crits.end();
+        if (!duplicate) { crits.push_back(&crit); }
+    }
+    if (targets.empty()) { return; }
+    // packages in install and upgrade requests (see installrequest/2 and upgraderequest/2)
+    std::vector<bool> inInstall(packages_.size()), inUpgrade(packages_.size());
+    for  (Request &request : install_) {
+        for  (Entity *ent : request.requests) {
+            if (Package *pkg = dynamic_cast<Package*>(ent)) { inInstall[pkg->id] = true; }
+        }
+    }
+    for  (Request &request : upgrade_) {
+        for  (Entity *ent : request.requests) {
+            if (Package *pkg = dynamic_cast<Package*>(ent)) { inUpgrade[pkg->id] = true; }
+        }
+    }
+    auto unit = [](Package const *pkg) { return pkg->visited && !pkg->remove_; };
+    // installed versions and candidates per package name
+    struct Name {
+        PackageList installed;
+        int32_t     min = 0;
+        int32_t     max = 0;
+        uint32_t    units = 0;
+        bool        done = false;
+    };
+    boost::unordered_map<uint32_t, Name> names;
+    for  (auto &pkg : packages_) {
+        Name &n = names[pkg->name];
+        if (unit(pkg.get())) { ++n.units; }
+        if (pkg->installed) {
+            if (n.installed.empty() || pkg->version < n.min) { n.min = pkg->version; }
+            if (n.installed.empty() || pkg->version > n.max) { n.max = pkg->version; }
+            n.installed.push_back(pkg.get());
+        }
+    }
+    // multiplicities of recommendations (see recommends/4)
+    auto recommends = [&](Package const *pkg) {
+        Weights ret;
+        for  (uint64_t rel : relations_[pkg->id]) {
+            if ((rel >> 32) == REC) { ++ret[static_cast<uint32_t>(rel)]; }
+        }
+        return ret;
+    };
+    // value of the attribute of a sum criterion if the attribute is dumped
+    auto attribute = [&](Package *pkg, uint32_t uid) -> int64_t {
+        bool recom = false;
+        std::set<uint32_t> attr;
+        pkg->criteriaAttrs(this, recom, attr);
+        int64_t scale = this->scale(uid);
+        return attr.find(uid) != attr.end() ? prop(*pkg, uid).second / std::max<int64_t>(scale, 1) : 0;
+    };
+    auto package = [&](Package const *pkg) -> FactWriter & {
+        return out << FactWriter::Symbol{pkg->name} << "," << pkg->version;
+    };
+    uint32_t objects = 0;
+    // object(C,S,T,P,V,M)
+    auto object = [&](Package *pkg, char const *set, Criterion::Selector sel) {
+        auto head = [&]() -> FactWriter & { return out << "object("; };
+        auto tail = [&]() -> FactWriter & {
+            out << "," << set << "," << selectorName(sel) << ",";
+            ++objects;
+            return package(pkg) << ",";
+        };
+        for  (Criterion const *crit : targets[sel]) {
+            switch (crit->measurement) {
+                case Criterion::COUNT: {
+                    head() << "count";
+                    tail() << "1).\n";
+                    break;
+                }
+                case Criterion::NOTUPTODATE: {
+                    if (!pkg->optMaxVersion) {
+                        head() << "notuptodate";
+                        tail() << "1).\n";
+                    }
+                    break;
+                }
+                case Criterion::SUM: {
+                    int64_t value = attribute(pkg, crit->attrUid1);
+                    if (value != 0) {
+                        head() << "sum(\"" << crit->attr1 << "\")";
+                        tail() << value << ").\n";
+                    }
+                    break;
+                }
+                case Criterion::UNSAT_RECOMMENDS: {
+                    for  (auto &rec : recommends(pkg)) {
+                        head() << "unsat_recommends(" << rec.first << ")";
+                        tail() << rec.second << ").\n";
+                    }
+                    break;
+                }
+                case Criterion::ALIGNED: { break; }
+            }
+        }
+    };
+    auto measures = [&](Criterion::Selector sel, Criterion::Measurement m) {
+        return boost::range::find_if(targets[sel], [m](Criterion const *crit) { return crit->measurement == m; }) != targets[sel].end();
+    };
+    // real cliques of packages and names whose candidates all belong to the
+    // same real clique (see realClique/3 and remClique/1)
+    std::vector<uint32_t> cliqueOf(packages_.size(), Aligned::NONE);
+    boost::unordered_map<uint32_t, uint32_t> remCliques;
+    uint32_t index = 0;
+    for  (PackageList &clique : conflictGraph_.cliques) {
+        boost::unordered_map<uint32_t, uint32_t> count;
+        uint32_t size = 0;
+        for  (Package *pkg : clique) {
+            if (unit(pkg)) {
+                ++count[pkg->name];
+                ++size;
+            }
+        }
+        if (size > 1) {
+            for  (Package *pkg : clique) {
+                if (unit(pkg)) { cliqueOf[pkg->id] = index; }
+            }
+            for  (auto &c : count) {
+                if (c.second == names[c.first].units) { remCliques.emplace(c.first, index); }
+            }
+        }
+        ++index;
+    }
+    std::vector<Aligned> aligned;
+    std::map<Criterion::Selector, std::vector<std::pair<Criterion const*, Aligned*>>> alignedTargets;
+    for  (auto &target : targets) {
+        for  (Criterion const *crit : target.second) {
+            if (crit->measurement == Criterion::ALIGNED) { aligned.emplace_back(*crit); }
+        }
+    }
+    for  (Aligned &al : aligned) {
+        Criterion const &crit = al.criterion();
+        alignedTargets[crit.selector].emplace_back(&crit, &al);
+    }
+    // lower bounds for count criteria: fixed packages in solution sets and
+    // all but one installed package per real clique in subtracted sets
+    std::map<Criterion::Selector, int64_t> bounds;
+    std::map<std::pair<Criterion::Selector, uint32_t>, int64_t> boundCliques;
+    // target(S,T,P,V), delete(T,P,V), and the objects of the targets
+    std::map<Criterion::Selector, Weights> statics;
+    for  (auto &pkg : packages_) {
+        Name &n = names[pkg->name];
+        bool in = unit(pkg.get());
+        bool recom = false;
+        std::set<uint32_t> attr;
+        if (!aligned.empty()) { pkg->criteriaAttrs(this, recom, attr); }
+        for  (auto &target : targets) {
+            Criterion::Selector sel = target.first;
+            bool sol = false, sub = false, del = false;
+            switch (sel) {
+                case Criterion::SOLUTION:       { sol = in; break; }
+                case Criterion::CHANGED:        { sol = in && !pkg->installed; sub = pkg->installed; del = !in; break; }
+                case Criterion::NEW:            { sol = in && n.installed.empty(); break; }
+                case Criterion::REMOVED:        { sub = pkg->installed; del = n.units == 0; break; }
+                case Criterion::UP:             { sol = in && !n.installed.empty() && pkg->version > n.max; break; }
+                case Criterion::DOWN:           { sol = in && !n.installed.empty() && pkg->version < n.min; break; }
+                case Criterion::INSTALLREQUEST: { sol = in && inInstall[pkg->id]; break; }
+                case Criterion::UPGRADEREQUEST: { sol = in && inUpgrade[pkg->id]; break; }
+                case Criterion::REQUEST:        { sol = in && (inInstall[pkg->id] || inUpgrade[pkg->id]); break; }
+            }
+            if (sol) {
+                out << "target(sol," << selectorName(sel) << ",";
+                package(pkg.get()) << ").\n";
+                object(pkg.get(), "sol", sel);
+                if (pkg->fixed) { ++bounds[sel]; }
+            }
+            if (sub) {
+                out << "target(sub," << selectorName(sel) << ",";
+                package(pkg.get()) << ").\n";
+                if (del) {
+                    out << "delete(" << selectorName(sel) << ",";
+                    package(pkg.get()) << ").\n";
+                    if (measures(sel, Criterion::UNSAT_RECOMMENDS)) {
+                        for  (auto &rec : recommends(pkg.get())) { statics[sel][rec.first] += rec.second; }
+                    }
+                }
+                else if (sel != Criterion::REMOVED) {
+                    object(pkg.get(), "sub", sel);
+                    if (cliqueOf[pkg->id] != Aligned::NONE) { ++boundCliques[{sel, cliqueOf[pkg->id]}]; }
+                }
+            }
+            if (sol || sub) {
+                for  (auto &al : alignedTargets[sel]) {
+                    Criterion const &crit = *al.first;
+                    if (attr.count(crit.attrUid1) > 0 && attr.count(crit.attrUid2) > 0) {
+                        al.second->add({pkg.get(), cliqueOf[pkg->id], sub, del, remCliques.count(pkg->name) > 0,
+                                        prop(*pkg, crit.attrUid1).second, prop(*pkg, crit.attrUid2).second});
+                    }
+                }
+            }
+        }
+    }
+    // static(T,unsat_recommends(D),M)
+    for  (auto &stat : statics) {
+        for  (auto &rec : stat.second) {
+            if (rec.second != 0) {
+                out << "static(" << selectorName(stat.first) << ",unsat_recommends(" << rec.first << ")," << rec.second << ").\n";
+            }
+        }
+    }
+    for  (Aligned &al : aligned) { al.dump(out); }
+    for  (auto &clique : boundCliques) { bounds[clique.first.first] += clique.second - 1; }
+    // remove(C,P,M) and remClique(P) for names with installed versions and
+    // candidates in the closure; all but one name per real clique have to
+    // be removed
+    std::map<uint32_t, std::pair<int64_t, int64_t>> removeCliques;
+    if (targets.count(Criterion::REMOVED) > 0) {
+        for  (auto &pkg : packages_) {
+            Name &n = names[pkg->name];
+            if (n.done || n.installed.empty() || n.units == 0) { continue; }
+            n.done = true;
+            FactWriter::Symbol name{pkg->name};
+            auto rem = remCliques.find(pkg->name);
+            if (rem != remCliques.end()) {
+                out << "remClique(" << name << ").\n";
+                auto &group = removeCliques[rem->second];
+                group.first += n.installed.size();
+                group.second = std::max<int64_t>(group.second, n.installed.size());
+            }
+            for  (Criterion const *crit : targets[Criterion::REMOVED]) {
+                switch (crit->measurement) {
+                    case Criterion::COUNT: {
+                        out << "remove(count," << name << "," << n.installed.size() << ").\n";
+                        break;
+                    }
+                    case Criterion::NOTUPTODATE: {
+                        int64_t m = 0;
+                        for  (Package *inst : n.installed) { m += !inst->optMaxVersion; }
+                        if (m > 0) { out << "remove(notuptodate," << name << "," << m << ").\n"; }
+                        break;
+                    }
+                    case Criterion::SUM: {
+                        int64_t m = 0;
+                        for  (Package *inst : n.installed) { m += attribute(inst, crit->attrUid1); }
+                        if (m != 0) { out << "remove(sum(\"" << crit->attr1 << "\")," << name << "," << m << ").\n"; }
+                        break;
+                    }
+                    case Criterion::UNSAT_RECOMMENDS: {
+                        Weights m;
+                        for  (Package *inst : n.installed) {
+                            for  (auto &rec : recommends(inst)) { m[rec.first] += rec.second; }
+                        }
+                        for  (auto &rec : m) {
+                            if (rec.second != 0) {
+                                out << "remove(unsat_recommends(" << rec.first << ")," << name << "," << rec.second << ").\n";
+                            }
+                        }
+                        break;
+                    }
+                    case Criterion::ALIGNED: { break; }
+                }
+            }
+        }
+        for  (auto &group : removeCliques) { bounds[Criterion::REMOVED] += group.second.first - group.second.second; }
+    }
+    // lowerbound(T,count,B)
+    int64_t bounded = 0;
+    for  (auto &bound : bounds) {
+        if (bound.second > 0 && measures(bound.first, Criterion::COUNT)) {
+            out << "lowerbound(" << selectorName(bound.first) << ",count," << bound.second << ").\n";
+            ++bounded;
+        }
+    }
+    if (verbose_) {
+        std::cerr << "objectives: " << std::endl;
+        std::cerr << "  objects:  " << objects << std::endl;
+        std::cerr << "  bounds:   " << bounded << std::endl;
+    }
+}
+
+void Dependency::dumpCliqueRelations(FactWriter &out) {
+    static char const *names[] = { "con", "dep", "rec", "sat" };
+    auto relation = [&](uint64_t rel) -> FactWriter & {
+        return out << names[rel >> 32] << "," << static_cast<uint32_t>(rel);
+    };
+    typedef boost::unordered_map<uint64_t, PackageList> MemberMap;
+    typedef boost::unordered_map<PackageList, std::vector<uint64_t>> GroupMap;
+    uint32_t joined = 0, groups = 0;
+    MemberMap members;
+    GroupMap equivalent;
+    uint32_t index = 0;
+    for  (PackageList &clique : conflictGraph_.cliques) {
+        // clique members in the closure and their shared relations
+        // (see realClique/3 and joinClique/4 in the encoding)
+        PackageList real;
+        for  (Package *pkg : clique) {
+            if (pkg->visited && !pkg->remove_) { real.push_back(pkg); }
+        }
+        if (real.size() > 1) {
+            members.clear();
+            equivalent.clear();
+            for  (Package *pkg : real) {
+                auto &rels = relations_[pkg->id];
+                sort_uniq(rels);
+                for  (uint64_t rel : rels) { members[rel].push_back(pkg); }
+            }
+            // relations shared by the same members are mapped to the
+            // smallest one (see equiClique/5 and mapsClique/5)
+            for  (auto &member : members) {
+                if (member.second.size() > 1) { equivalent[member.second].push_back(member.first); }
+            }
+            // groups are printed ordered by their smallest relation
+            std::vector<GroupMap::value_type*> sorted;
+            for  (auto &group : equivalent) {
+                boost::sort(group.second);
+                sorted.push_back(&group);
+            }
+            boost::sort(sorted, [](GroupMap::value_type *a, GroupMap::value_type *b) {
+                return a->second.front() < b->second.front();
+            });
+            for  (auto *group : sorted) {
+                auto &rels = group->second;
+                for  (Package *pkg : group->first) {
+                    out << "relaClique(" << index << "," << FactWriter::Symbol{pkg->name} << "," << pkg->version << ",";
+                    relation(rels.front()) << ").\n";
+                }
+                out << "joinClique(" << index << ",";
+                relation(rels.front()) << "," << group->first.size() << ").\n";
+                for  (uint64_t rel : rels) {
+                    out << "mapsClique(" << index << ",";
+                    relation(rels.front()) << ",";
+                    relation(rel) << ").\n";
+                }
+                joined += rels.size();
+                ++groups;
+            }
+        }
+        ++index;
+    }
+    if (verbose_) {
+        std::cerr << "clique relations: " << std::endl;
+        std::cerr << "  joined:   " << joined << std::endl;
+        std::cerr << "  groups:   " << groups << std::endl;
+    }
+}
+
+void Dependency::initScales() {
+    // values of attributes that are only used by sum criteria can be divided
+    // by their greatest common divisor without changing optimal solutions
+    scales_.clear();
+    for  (Criterion &crit : criteria.criteria) {
+        if (crit.measurement == Criterion::SUM) { scales_.emplace(crit.attrUid1, 0); }
+    }
+    for  (Criterion &crit : criteria.criteria) {
+        if (crit.measurement == Criterion::ALIGNED) {
+            scales_.erase(crit.attrUid1);
+            scales_.erase(crit.attrUid2);
+        }
+    }
+    if (scales_.empty()) { return; }
+    for  (auto &pkg : packages_) {
+        bool recom = false;
+        std::set<uint32_t> attr;
+        pkg->criteriaAttrs(this, recom, attr);
+        for  (uint32_t uid : attr) {
+            auto it = scales_.find(uid);
+            if (it == scales_.end() || it->second < 0) { continue; }
+            if (pkg->stringProps.find(uid) != pkg->stringProps.end()) { it->second = -1; }
+            else {
+                auto jt = pkg->intProps.find(uid);
+                if (jt != pkg->intProps.end()) { it->second = gcd(it->second, jt->second); }
+            }
+        }
+    }
+    for  (auto it = scales_.begin(); it != scales_.end(); ) {
+        if (it->second < 0) { it = scales_.erase(it); }
+        else {
+            if (it->second == 0) { it->second = 1; }
+            ++it;
+        }
+    }
+    if (verbose_) {
+        std::cerr << "scales: " << std::endl;
+        for  (auto &scale : scales_) {
+            std::cerr << "  " << string(scale.first) << ": " << scale.second << std::endl;
+        }
+    }
+}
+
+int64_t Dependency::scale(uint32_t uid) const {
+    auto it = scales_.find(uid);
+    return it != scales_.end() ? it->second : 0;
+}
+
+void Dependency::dumpAsFacts(std::ostream &out, std::ostream *symbols) {
+    FactWriter writer(out, [this](uint32_t index) -> std::string const & { return string(index); });
+    if (symbols) { writer.symbols(*symbols); }
+    dumpAsFacts(writer);
+}
+
+void Dependency::dumpPackages(FactWriter &out) {
+    // the attributes of all packages followed by the facts of the packages in
+    // the closure; they are processed in blocks where first the clauses of
+    // the block are computed in parallel, then the clauses are numbered
+    // sequentially, and finally the facts of consecutive chunks of the
+    // block are written in parallel and concatenated in order, so that the
+    // output does not depend on the number of threads
+    std::vector<std::pair<Package*, bool>> items;
+    for  (auto &pkg : packages_) { items.emplace_back(pkg.get(), true); }
+    for  (Entity *ent : closure_) {
+        Package *pkg = dynamic_cast<Package*>(ent);
+        if (pkg) { items.emplace_back(pkg, false); }
+    }
+    size_t const blockSize = 16384;
+    std::vector<ClauseList> clauses(blockSize);
+    std::vector<std::vector<uint64_t>> prints(blockSize);
+    std::vector<ConditionList> conds(blockSize);
+    std::vector<std::ostringstream> chunks(threads_);
+    for  (size_t offset = 0; offset < items.size(); offset += blockSize) {
+        size_t size = std::min(blockSize, items.size() - offset);
+        parallel_chunks(threads_, size, [&](unsigned, size_t begin, size_t end) {
+            for  (size_t i = begin; i != end; ++i) {
+                Package *pkg = items[offset + i].first;
+                clauses[i].clear();
+                prints[i].clear();
+                if (items[offset + i].second) { pkg->attrClauses(this, clauses[i]); }
+                else                          { pkg->factClauses(clauses[i]); }
+                for  (auto &clause : clauses[i]) { prints[i].emplace_back(ClausePool::fingerprint(clause)); }
+            }
+        });
+        for  (size_t i = 0; i != size; ++i) {
+            Package *pkg = items[offset + i].first;
+            bool attrs = items[offset + i].second;
+            conds[i].clear();
+            for  (size_t j = 0; j != clauses[i].size(); ++j) {
+                conds[i].emplace_back(insertClause(clauses[i][j], prints[i][j]));
+                relate(pkg, attrs ? REC : j < pkg->depends.size() ? DEP : CON, conds[i].back().first);
+            }
+        }
+        auto dump = [&](FactWriter &writer, size_t begin, size_t end) {
+            for  (size_t i = begin; i != end; ++i) {
+                if (items[offset + i].second) { items[offset + i].first->dumpAttrs(this, writer, conds[i]); }
+                else                          { items[offset + i].first->dumpAsFacts(this, writer, conds[i]); }
+            }
+        };
+        // dense integers for package names are assigned in order of their
+        // first occurrence and cannot be assigned in parallel
+        if (threads_ <= 1 || out.symbolic()) { dump(out, 0, size); }
+        else {
+            parallel_chunks(threads_, size, [&](unsigned thread, size_t begin, size_t end) {
+                FactWriter writer(chunks[thread], [this](uint32_t index) -> std::string const & { return string(index); });
+                dump(writer, begin, end);
+            });
+            for  (auto &chunk : chunks) {
+                out << chunk.str();
+                chunk.str("");
+            }
+        }
+    }
+}
+
+void Dependency::dumpAsFacts(FactWriter &out) {
     bool installrequest = false;
     bool upgraderequest = false;
     for  (Criterion &crit : criteria.criteria) {
         if (crit.selector == Criterion::INSTALLREQUEST || crit.selector == Criterion::REQUEST) { installrequest = true; }
         if (crit.selector == Criterion::UPGRADEREQUEST || crit.selector == Criterion::REQUEST) { upgraderequest = true; }
     }
-    for  (auto &pkg : packages_) { pkg->dumpAttrs(this, out); }
-    for  (Entity *ent : closure_) { ent->dumpAsFacts(this, out); }
+    if (precompute_) { relations_.resize(packages_.size()); }
+    if (ranges_) { initSuccessors(); }
+    initScales();
+    dumpPackages(out);
     // requests according to install request
     for  (Request &request : install_) {
         PackageList pkgClause;
@@ -782,7 +2605,7 @@ void Dependency::dumpAsFacts(std::ostream &out) {
             ent->addToClause(pkgClause);
             Package *pkg = dynamic_cast<Package*>(ent);
             if (installrequest && pkg) {
-                out << "installrequest(\"" << string(pkg->name) << "\"," << pkg->version << ").\n";
+                out << "installrequest(" << FactWriter::Symbol{pkg->name} << "," << pkg->version << ").\n";
             }
         }
         uint32_t condition = addClause(pkgClause, out);
@@ -795,7 +2618,7 @@ void Dependency::dumpAsFacts(std::ostream &out) {
             ent->addToClause(pkgClause);
             Package *pkg = dynamic_cast<Package*>(ent);
             if (upgraderequest && pkg) {
-                out << "upgraderequest(\"" << string(pkg->name) << "\"," << pkg->version << ").\n";
+                out << "upgraderequest(" << FactWriter::Symbol{pkg->name} << "," << pkg->version << ").\n";
             }
         }
         uint32_t condition = addClause(pkgClause, out);
@@ -816,27 +2639,29 @@ void Dependency::dumpAsFacts(std::ostream &out) {
             ent->addToClause(pkgReason);
             sort_uniq_ptr(pkgReason);
             for  (Package *pkg : pkgReason) {
-                out << "conflict(\"" << string(pkg->name) << "\"," << pkg->version << "," << condition << ").\n";
+                relate(pkg, CON, condition);
+                out << "conflict(" << FactWriter::Symbol{pkg->name} << "," << pkg->version << "," << condition << ").\n";
             }
         }
     }
-    conflictGraph_.dump(this, out);
+    conflictGraph_.dump(out);
+    if (precompute_) {
+        // NOTE: objectives have to be dumped first because they need the
+        //       multiplicities of recommendations
+        dumpObjectives(out);
+        dumpCliqueRelations(out);
+    }
+    // symmetric versions
+    for  (PackageList &sym : symmetries_) {
+        for  (auto it = sym.begin() + 1, ie = sym.end(); it != ie; ++it) {
+            out << "symmetry(" << FactWriter::Symbol{(*it)->name} << "," << (*(it - 1))->version << "," << (*it)->version << ").\n";
+        }
+    }
     // criteria
     int priotity = criteria.criteria.size();
     for  (Criterion &crit : criteria.criteria) {
         out << "criterion(" << (crit.optimize ? "maximize" : "minimize") << ",";
-        switch (crit.selector) {
-            case Criterion::SOLUTION:       { out << "solution"; break;  }
-            case Criterion::NEW:            { out << "new"; break;  }
-            case Criterion::REMOVED:        { out << "removed"; break;  }
-            case Criterion::CHANGED:        { out << "changed"; break;  }
-            case Criterion::UP:             { out << "up"; break;  }
-            case Criterion::DOWN:           { out << "down"; break;  }
-            case Criterion::INSTALLREQUEST: { out << "installrequest"; break;  }
-            case Criterion::UPGRADEREQUEST: { out << "upgraderequest"; break;  }
-            case Criterion::REQUEST:        { out << "request"; break;  }
-        }
-        out << ",";
+        out << selectorName(crit.selector) << ",";
         switch (crit.measurement) {
             case Criterion::COUNT:            { out << "count"; break;  }
             case Criterion::SUM:              { out << "sum(\"" << crit.attr1 << "\")"; break;  }
@@ -844,7 +2669,12 @@ void Dependency::dumpAsFacts(std::ostream &out) {
             case Criterion::NOTUPTODATE:      { out << "notuptodate"; break;  }
             case Criterion::ALIGNED:          { out << "aligned(\"" << crit.attr1 << "\",\"" << crit.attr2 << "\")"; break;  }
         }
-        out << "," << priotity-- << ").\n";
+        out << "," << priotity << ").\n";
+        // scale(L,K): the values of the criterion with priority L have been divided by K
+        if (crit.measurement == Criterion::SUM && scale(crit.attrUid1) > 1) {
+            out << "scale(" << priotity << "," << scale(crit.attrUid1) << ").\n";
+        }
+        --priotity;
     }
 }
 
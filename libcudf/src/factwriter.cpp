@@ -0,0 +1,88 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble ///////////////////////// {{{1
+
+#include <cudf/factwriter.hh>
+
+//////////////////// FactWriter /////////////////////// {{{1
+
+FactWriter::FactWriter(std::ostream &out, Resolver resolve, size_t capacity)
+    : out_(out)
+    , resolve_(std::move(resolve))
+    , buf_(capacity) { }
+
+FactWriter::~FactWriter() {
+    flush();
+}
+
+FactWriter &FactWriter::operator<<(Quoted str) {
+    if (str.index >= quoted_.size()) { quoted_.resize(str.index + 1); }
+    std::string &quoted = quoted_[str.index];
+    if (quoted.empty()) {
+        std::string const &value = resolve_(str.index);
+        quoted.reserve(value.size() + 2);
+        quoted.push_back('"');
+        quoted.append(value);
+        quoted.push_back('"');
+    }
+    return *this << quoted;
+}
+
+FactWriter &FactWriter::operator<<(Symbol sym) {
+    if (!table_) { return *this << Quoted{sym.index}; }
+    if (sym.index >= symbols_.size()) { symbols_.resize(sym.index + 1, 0); }
+    uint32_t &id = symbols_[sym.index];
+    if (id == 0) {
+        id = ++numSymbols_;
+        *table_ << id << " " << resolve_(sym.index) << "\n";
+    }
+    return *this << id;
+}
+
+FactWriter &FactWriter::write(char const *str, size_t len) {
+    if (size_ + len > buf_.size()) {
+        flush();
+        // large blocks are passed through
+        if (len > buf_.size()) {
+            out_.write(str, len);
+            return *this;
+        }
+    }
+    std::memcpy(buf_.data() + size_, str, len);
+    size_ += len;
+    return *this;
+}
+
+void FactWriter::flush() {
+    if (size_ > 0) {
+        out_.write(buf_.data(), size_);
+        size_ = 0;
+    }
+    out_.flush();
+    if (table_) { table_->flush(); }
+}
+
+void FactWriter::symbols(std::ostream &table) {
+    table_ = &table;
+}
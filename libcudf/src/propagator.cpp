@@ -0,0 +1,175 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble ///////////////////////// {{{1
+
+#include <cudf/propagator.hh>
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+//////////////////// Propagator /////////////////////// {{{1
+
+constexpr uint32_t Propagator::NONE;
+
+Propagator::Propagator(uint32_t size)
+    : occurs_(size)
+    , depends_(size)
+    , conflicts_(size)
+    , state_(size) { }
+
+uint32_t Propagator::addClause_(uint32_t owner, Clause const &clause) {
+    uint32_t index = clauses_.size();
+    clauses_.push_back({static_cast<uint32_t>(lits_.size()), static_cast<uint32_t>(clause.size()), owner});
+    lits_.insert(lits_.end(), clause.begin(), clause.end());
+    for (uint32_t pkg : clause) { occurs_[pkg].push_back(index); }
+    return index;
+}
+
+void Propagator::addDepends(uint32_t pkg, Clause const &clause) {
+    depends_[pkg].push_back(addClause_(pkg, clause));
+}
+
+void Propagator::addConflict(uint32_t a, uint32_t b) {
+    conflicts_[a].push_back(b);
+    if (a != b) { conflicts_[b].push_back(a); }
+}
+
+void Propagator::addRequest(Clause const &clause) {
+    addClause_(NONE, clause);
+}
+
+bool Propagator::assign(uint32_t pkg, Value val) {
+    return assign_(state_, pkg, val);
+}
+
+Propagator::Value Propagator::value(uint32_t pkg) const {
+    return state_.values[pkg];
+}
+
+uint32_t Propagator::size() const {
+    return state_.values.size();
+}
+
+bool Propagator::assign_(State &state, uint32_t pkg, Value val) const {
+    if (state.values[pkg] == FREE) {
+        state.values[pkg] = val;
+        state.trail.push_back(pkg);
+        return true;
+    }
+    return state.values[pkg] == val;
+}
+
+bool Propagator::check_(State &state, uint32_t index) const {
+    ClauseInfo const &clause = clauses_[index];
+    uint32_t free = 0, last = 0;
+    for (auto it = lits_.begin() + clause.offset, ie = it + clause.size; it != ie; ++it) {
+        switch (state.values[*it]) {
+            case TRUE:  { return true; }
+            case FALSE: { break; }
+            case FREE:  { ++free; last = *it; break; }
+        }
+    }
+    Value owner = clause.owner == NONE ? TRUE : state.values[clause.owner];
+    switch (owner) {
+        // the clause has to be satisfied
+        case TRUE:  { return free > 1 || (free == 1 && assign_(state, last, TRUE)); }
+        // the owner cannot be installed if the clause is falsified
+        case FREE:  { return free > 0 || assign_(state, clause.owner, FALSE); }
+        case FALSE: { return true; }
+    }
+    assert(false);
+    return true;
+}
+
+bool Propagator::propagate_(State &state) const {
+    for (; state.head < state.trail.size(); ++state.head) {
+        uint32_t pkg = state.trail[state.head];
+        if (state.values[pkg] == TRUE) {
+            for (uint32_t other : conflicts_[pkg]) {
+                if (!assign_(state, other, FALSE)) { return false; }
+            }
+            for (uint32_t clause : depends_[pkg]) {
+                if (!check_(state, clause)) { return false; }
+            }
+        }
+        else {
+            for (uint32_t clause : occurs_[pkg]) {
+                if (!check_(state, clause)) { return false; }
+            }
+        }
+    }
+    return true;
+}
+
+bool Propagator::propagate() {
+    for (uint32_t pkg = 0; pkg < conflicts_.size(); ++pkg) {
+        for (uint32_t other : conflicts_[pkg]) {
+            if (other == pkg && !assign_(state_, pkg, FALSE)) { return false; }
+        }
+    }
+    for (uint32_t clause = 0; clause < clauses_.size(); ++clause) {
+        if (!check_(state_, clause)) { return false; }
+    }
+    return propagate_(state_);
+}
+
+bool Propagator::probe_(State &state, uint32_t pkg, std::vector<bool> &implied) const {
+    size_t level = state.trail.size();
+    bool ret = assign_(state, pkg, TRUE) && propagate_(state);
+    // undo the assignment; if the probe succeeded, probing any package
+    // installed along the way succeeds, too
+    for (size_t i = level; i < state.trail.size(); ++i) {
+        uint32_t other = state.trail[i];
+        if (ret && state.values[other] == TRUE) { implied[other] = true; }
+        state.values[other] = FREE;
+    }
+    state.trail.resize(level);
+    state.head = level;
+    return ret;
+}
+
+Propagator::Clause Propagator::failed(unsigned threads) const {
+    assert(state_.head == state_.trail.size());
+    threads = std::max(1u, std::min<unsigned>(threads, size()));
+    // packages are distributed round-robin to the threads, which write the
+    // failed ones into separate lists that are merged afterwards
+    std::vector<Clause> failed(threads);
+    auto probe = [&](unsigned thread) {
+        State state(state_);
+        std::vector<bool> implied(size());
+        for (uint32_t pkg = thread; pkg < size(); pkg += threads) {
+            if (state.values[pkg] == FREE && !implied[pkg] && !probe_(state, pkg, implied)) {
+                failed[thread].push_back(pkg);
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned thread = 1; thread < threads; ++thread) { workers.emplace_back(probe, thread); }
+    probe(0);
+    for (std::thread &worker : workers) { worker.join(); }
+    Clause ret;
+    for (Clause &part : failed) { ret.insert(ret.end(), part.begin(), part.end()); }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
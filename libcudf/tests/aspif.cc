@@ -0,0 +1,138 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+#include "helpers.hh"
+#include <cudf/aspif.hh>
+#include <limits>
+
+//////////////////// Aspif ////////////////////////////////////// {{{1
+
+TEST_CASE("aspif", "[aspif]") {
+    SECTION("test_writer") {
+        std::ostringstream out;
+        {
+            FactWriter writer(out, nullptr);
+            AspifWriter prg(writer);
+            auto a = prg.atom(), b = prg.atom();
+            prg.rule({a}, {}, true);
+            prg.rule({b}, {-static_cast<AspifWriter::Literal>(a)});
+            prg.rule({}, {static_cast<AspifWriter::Literal>(prg.top())});
+            prg.minimize(1, {{a, 2}, {b, -1}});
+            prg.output("in(\"a\",1)", {static_cast<AspifWriter::Literal>(a)});
+            prg.end();
+            REQUIRE(prg.atoms() == 3);
+            REQUIRE(prg.rules() == 4);
+        }
+        REQUIRE(out.str() ==
+            "asp 1 0 0\n"
+            "1 1 1 1 0 0\n"
+            "1 0 1 2 0 1 -1\n"
+            "1 0 1 3 0 0\n"
+            "1 0 0 0 1 3\n"
+            "2 1 2 1 2 2 -1\n"
+            "4 9 in(\"a\",1) 1 1\n"
+            "0\n");
+    }
+
+    SECTION("test_weight_range") {
+        std::ostringstream out;
+        FactWriter writer(out, nullptr);
+        AspifWriter prg(writer);
+        auto a = prg.atom();
+        int64_t max = std::numeric_limits<int32_t>::max(), min = std::numeric_limits<int32_t>::min();
+        REQUIRE_THROWS_AS(prg.minimize(0, {{a, max + 1}}), std::runtime_error);
+        REQUIRE_THROWS_AS(prg.minimize(min - 1, {{a, 1}}), std::runtime_error);
+    }
+
+    SECTION("test_program") {
+        std::string universe =
+            "package: a\n"
+            "version: 1\n"
+            "installed: true\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "depends: a = 2\n"
+            "\n"
+            "request: \n"
+            "install: b\n";
+        Criteria::CritVec crits;
+        for (auto crit : {
+            createCrits(false, Criterion::COUNT, Criterion::REMOVED),
+            createCrits(false, Criterion::COUNT, Criterion::CHANGED),
+            createCrits(true, Criterion::NOTUPTODATE, Criterion::SOLUTION) }) {
+            crits.push_back(crit.front());
+        }
+        TestDep d(crits, universe);
+        auto prg = d.aspif();
+        REQUIRE(prg.front() == "asp 1 0 0");
+        REQUIRE(prg.back() == "0");
+        REQUIRE(count(prg, "4 ") == 3);
+        REQUIRE(count(prg, "4 9 in(\"a\",2) 1 ") == 1);
+        REQUIRE(count(prg, "1 1 1 ") == 3);
+        // one minimize statement per criterion ordered by priority
+        REQUIRE(count(prg, "2 ") == 3);
+        REQUIRE(count(prg, "2 3 ") == 1);
+        REQUIRE(count(prg, "2 1 1 ") == 1);
+        // the changed set contains every version
+        REQUIRE(count(prg, "2 2 3 ") == 1);
+    }
+
+    SECTION("test_changes") {
+        std::string universe =
+            "package: a\n"
+            "version: 1\n"
+            "installed: true\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "depends: a\n"
+            "\n"
+            "package: c\n"
+            "version: 1\n"
+            "installed: true\n"
+            "depends: d\n"
+            "\n"
+            "request: \n"
+            "install: b\n";
+        Criteria::CritVec crits;
+        TestDep d(crits, universe);
+        auto prg = d.aspif(true);
+        REQUIRE(count(prg, "4 ") == 4);
+        REQUIRE(count(prg, "4 9 in(\"a\",2) 1 ") == 1);
+        REQUIRE(count(prg, "4 9 in(\"b\",1) 1 ") == 1);
+        // installed packages are shown if they are removed
+        REQUIRE(count(prg, "4 10 out(\"a\",1) 1 -") == 1);
+        REQUIRE(count(prg, "4 10 out(\"c\",1) 0") == 1);
+        std::ostringstream out;
+        d.dep.dumpInstalled(out);
+        REQUIRE(out.str() == "a 1 1\nc 1 0\n");
+    }
+}
@@ -0,0 +1,66 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+#include "catch.hpp"
+#include <cudf/clausepool.hh>
+
+//////////////////// ClausePool ///////////////////////////////// {{{1
+
+TEST_CASE("clausepool", "[clausepool]") {
+    // only the addresses of the packages are used
+    std::vector<char> storage(4096);
+    auto pkg = [&](size_t i) { return reinterpret_cast<Package*>(storage.data() + i); };
+    ClausePool pool;
+
+    SECTION("test_insert") {
+        REQUIRE(pool.insert({pkg(1), pkg(2)}) == std::make_pair(1u, true));
+        REQUIRE(pool.insert({pkg(2)}) == std::make_pair(2u, true));
+        REQUIRE(pool.insert({}) == std::make_pair(3u, true));
+        REQUIRE(pool.insert({pkg(1), pkg(2)}) == std::make_pair(1u, false));
+        REQUIRE(pool.insert({}) == std::make_pair(3u, false));
+        REQUIRE(pool.insert({pkg(2), pkg(1)}) == std::make_pair(4u, true));
+        REQUIRE(pool.size() == 4);
+        auto range = pool.clause(1);
+        REQUIRE(ClausePool::Clause(range.first, range.second) == ClausePool::Clause({pkg(1), pkg(2)}));
+        range = pool.clause(3);
+        REQUIRE(range.first == range.second);
+    }
+
+    SECTION("test_grow") {
+        // the table is rehashed several times while ids stay stable
+        bool added = true;
+        for (uint32_t i = 0; i < 4000; ++i) {
+            added = added && pool.insert({pkg(i), pkg(i + 1)}) == std::make_pair(i + 1, true);
+        }
+        REQUIRE(added);
+        bool stable = true;
+        for (uint32_t i = 0; i < 4000; ++i) {
+            stable = stable && pool.insert({pkg(i), pkg(i + 1)}) == std::make_pair(i + 1, false);
+            auto range = pool.clause(i + 1);
+            stable = stable && range.second - range.first == 2 && *range.first == pkg(i);
+        }
+        REQUIRE(stable);
+        REQUIRE(pool.size() == 4000);
+    }
+}
@@ -0,0 +1,104 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+#include "catch.hpp"
+#include <cudf/clausewriter.hh>
+#include <sstream>
+
+//////////////////// ClauseWriter /////////////////////////////// {{{1
+
+namespace {
+
+// {a}. b :- a. b :- not a, c. :- not b.
+// #minimize { 1@2 : a; 2@1 : b; -1@1 : c }.
+std::string write(ClauseWriter::Format format) {
+    std::ostringstream out;
+    FactWriter writer(out, nullptr);
+    ClauseWriter prg(writer, format);
+    auto a = prg.atom(), b = prg.atom(), c = prg.atom();
+    prg.rule({a}, {}, true);
+    prg.rule({b}, {static_cast<GroundProgram::Literal>(a)});
+    prg.rule({b}, {-static_cast<GroundProgram::Literal>(a), static_cast<GroundProgram::Literal>(c)});
+    prg.rule({}, {-static_cast<GroundProgram::Literal>(b)});
+    prg.minimize(2, {{a, 1}});
+    prg.minimize(1, {{b, 2}, {c, -1}});
+    prg.output("a", {static_cast<GroundProgram::Literal>(a)});
+    prg.end();
+    REQUIRE(prg.atoms() == 4);
+    REQUIRE(prg.clauses() == 8);
+    return out.str();
+}
+
+}
+
+TEST_CASE("clausewriter", "[clausewriter]") {
+    SECTION("test_wcnf") {
+        // the weight of the second level is multiplied by 2 + 1 + 1
+        REQUIRE(write(ClauseWriter::WCNF) ==
+            "p wcnf 4 11 8\n"
+            "c show 1 a\n"
+            "2 -2 0\n"
+            "1 3 0\n"
+            "4 -1 0\n"
+            "8 2 0\n"
+            "8 -1 2 0\n"
+            "8 -4 -1 0\n"
+            "8 -4 3 0\n"
+            "8 4 1 -3 0\n"
+            "8 -4 2 0\n"
+            "8 -2 1 4 0\n"
+            "8 -3 0\n");
+    }
+
+    SECTION("test_opb") {
+        REQUIRE(write(ClauseWriter::OPB) ==
+            "* #variable= 4 #constraint= 8\n"
+            "* show 1 a\n"
+            "min: +2 x2 +1 ~x3 +4 x1 ;\n"
+            "+1 x2 >= 1 ;\n"
+            "+1 ~x1 +1 x2 >= 1 ;\n"
+            "+1 ~x4 +1 ~x1 >= 1 ;\n"
+            "+1 ~x4 +1 x3 >= 1 ;\n"
+            "+1 x4 +1 x1 +1 ~x3 >= 1 ;\n"
+            "+1 ~x4 +1 x2 >= 1 ;\n"
+            "+1 ~x2 +1 x1 +1 x4 >= 1 ;\n"
+            "+1 ~x3 >= 1 ;\n");
+    }
+
+    SECTION("test_empty_clause") {
+        // :- .
+        for (auto format : {ClauseWriter::WCNF, ClauseWriter::OPB}) {
+            std::ostringstream out;
+            FactWriter writer(out, nullptr);
+            ClauseWriter prg(writer, format);
+            prg.rule({}, {});
+            prg.end();
+            REQUIRE(out.str() == (format == ClauseWriter::WCNF
+                ? "p wcnf 0 1 1\n"
+                  "1 0\n"
+                : "* #variable= 1 #constraint= 1\n"
+                  "+0 x1 >= 1 ;\n"));
+        }
+    }
+}
@@ -0,0 +1,92 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+
+
+#include "helpers.hh"
+
+//////////////////// Condensation /////////////////////////////// {{{1
+
+TEST_CASE("condensation", "[condensation]") {
+    SECTION("test_components") {
+        TestDep d(Criteria::CritVec(),
+            "package: lib\n"
+            "version: 1\n"
+            "depends: lib-common, lib-data | other\n"
+            "\n"
+            "package: lib-common\n"
+            "version: 1\n"
+            "depends: lib-data\n"
+            "\n"
+            "package: lib-data\n"
+            "version: 1\n"
+            "depends: lib\n"
+            "\n"
+            "package: app\n"
+            "version: 1\n"
+            "depends: lib, tool\n"
+            "\n"
+            "package: tool\n"
+            "version: 1\n"
+            "depends: app | other\n"
+            "\n"
+            "package: other\n"
+            "version: 1\n"
+            "\n"
+            "request: \n"
+            "install: app, other\n"
+        );
+        REQUIRE( d.condensed("lib", 1, "lib-common", 1));
+        REQUIRE( d.condensed("lib", 1, "lib-data", 1));
+        REQUIRE(!d.condensed("lib", 1, "app", 1));
+        REQUIRE(!d.condensed("app", 1, "tool", 1));
+        REQUIRE(!d.condensed("other", 1, "other", 1));
+    }
+
+    SECTION("test_versions") {
+        TestDep d(Criteria::CritVec(),
+            "package: a\n"
+            "version: 1\n"
+            "depends: b = 1\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "depends: b = 2\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "depends: a = 1\n"
+            "\n"
+            "package: b\n"
+            "version: 2\n"
+            "depends: a\n"
+            "\n"
+            "request: \n"
+            "install: a\n"
+        );
+        REQUIRE( d.condensed("a", 1, "b", 1));
+        REQUIRE(!d.condensed("a", 1, "a", 2));
+        REQUIRE(!d.condensed("a", 2, "b", 2));
+    }
+}
@@ -0,0 +1,143 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+
+
+#include "helpers.hh"
+
+//////////////////// Dominance ////////////////////////////////// {{{1
+
+TEST_CASE("dominance", "[dominance]") {
+    DependencyOptions opts = testOptions();
+    opts.dominance = true;
+    std::string pkgs =
+        "package: a\n"
+        "version: 1\n"
+        "depends: c\n"
+        "conflicts: e\n"
+        "\n"
+        "package: a\n"
+        "version: 2\n"
+        "depends: c\n"
+        "\n"
+        "package: b\n"
+        "version: 1\n"
+        "depends: a\n"
+        "\n"
+        "package: c\n"
+        "version: 1\n"
+        "\n"
+        "package: e\n"
+        "version: 1\n"
+        "\n";
+
+    SECTION("test_conflicts") {
+        TestDep d(createCrits(false, Criterion::COUNT, Criterion::NEW), pkgs +
+            "request: \n"
+            "install: b\n",
+            opts);
+        REQUIRE( d.removed("a", 1));
+        REQUIRE(!d.removed("a", 2));
+        REQUIRE(!d.contains("e", 1));
+    }
+
+    SECTION("test_installed") {
+        TestDep d(createCrits(false, Criterion::COUNT, Criterion::SOLUTION),
+            "package: a\n"
+            "version: 1\n"
+            "installed: true\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "\n"
+            "request: \n"
+            "install: a\n",
+            opts);
+        REQUIRE(!d.removed("a", 1));
+        REQUIRE( d.removed("a", 2));
+    }
+
+    SECTION("test_occurrences") {
+        TestDep d(Criteria::CritVec(), pkgs +
+            "package: f\n"
+            "version: 1\n"
+            "depends: a = 1 | e\n"
+            "\n"
+            "request: \n"
+            "install: b, f\n",
+            opts);
+        REQUIRE(!d.removed("a", 1));
+        REQUIRE(!d.removed("a", 2));
+    }
+
+    SECTION("test_sum") {
+        TestDep d(createCrits(false, Criterion::SUM, Criterion::SOLUTION, "size"),
+            "preamble: \n"
+            "property: size: int = [0]\n"
+            "\n"
+            "package: a\n"
+            "version: 1\n"
+            "size: 1\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "size: 5\n"
+            "\n"
+            "request: \n"
+            "install: a\n",
+            opts);
+        REQUIRE(!d.removed("a", 1));
+        REQUIRE( d.removed("a", 2));
+    }
+
+    SECTION("test_notuptodate") {
+        TestDep d(createCrits(false, Criterion::NOTUPTODATE, Criterion::SOLUTION),
+            "package: a\n"
+            "version: 1\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "\n"
+            "request: \n"
+            "install: a\n",
+            opts);
+        REQUIRE( d.removed("a", 1));
+        REQUIRE(!d.removed("a", 2));
+    }
+
+    SECTION("test_maximize") {
+        TestDep d(createCrits(true, Criterion::COUNT, Criterion::SOLUTION),
+            "package: a\n"
+            "version: 1\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "\n"
+            "request: \n"
+            "install: a\n",
+            opts);
+        REQUIRE(!d.removed("a", 1));
+        REQUIRE(!d.removed("a", 2));
+    }
+}
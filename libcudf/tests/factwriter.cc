@@ -0,0 +1,87 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+#include "catch.hpp"
+#include <cudf/factwriter.hh>
+#include <limits>
+#include <sstream>
+
+//////////////////// FactWriter ///////////////////////////////// {{{1
+
+TEST_CASE("factwriter", "[factwriter]") {
+    std::vector<std::string> strings{"a", "bc"};
+    uint32_t lookups = 0;
+    auto resolve = [&](uint32_t index) -> std::string const & {
+        ++lookups;
+        return strings[index];
+    };
+    std::ostringstream out;
+
+    SECTION("test_integers") {
+        {
+            FactWriter writer(out, resolve);
+            writer << 0 << ',' << -7 << ',' << 42u << ',' << std::numeric_limits<int32_t>::min() << ',';
+            writer << std::numeric_limits<int64_t>::min() << ',' << std::numeric_limits<uint64_t>::max();
+        }
+        REQUIRE(out.str() == "0,-7,42,-2147483648,-9223372036854775808,18446744073709551615");
+    }
+
+    SECTION("test_quoted") {
+        {
+            FactWriter writer(out, resolve);
+            writer << "p(" << FactWriter::Quoted{1} << "," << FactWriter::Quoted{0} << ").\n";
+            writer << "q(" << FactWriter::Quoted{1} << ").\n";
+        }
+        REQUIRE(out.str() == "p(\"bc\",\"a\").\nq(\"bc\").\n");
+        REQUIRE(lookups == 2);
+    }
+
+    SECTION("test_symbols") {
+        std::ostringstream table;
+        {
+            FactWriter writer(out, resolve);
+            writer << "p(" << FactWriter::Symbol{1} << ").\n";
+            writer.symbols(table);
+            writer << "p(" << FactWriter::Symbol{1} << "," << FactWriter::Quoted{0} << ").\n";
+            writer << "q(" << FactWriter::Symbol{0} << "," << FactWriter::Symbol{1} << ").\n";
+        }
+        REQUIRE(out.str() == "p(\"bc\").\np(1,\"a\").\nq(2,1).\n");
+        REQUIRE(table.str() == "1 bc\n2 a\n");
+    }
+
+    SECTION("test_flush") {
+        // facts exceeding the buffer are passed through in order
+        std::string expected;
+        {
+            FactWriter writer(out, resolve, 8);
+            for (int i = 0; i < 100; ++i) {
+                writer << "x(" << i << ").\n";
+                expected += "x(" + std::to_string(i) + ").\n";
+            }
+            writer << std::string(20, 'y');
+            expected += std::string(20, 'y');
+        }
+        REQUIRE(out.str() == expected);
+    }
+}
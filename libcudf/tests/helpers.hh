@@ -25,16 +25,27 @@
 
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <cudf/parser.hh>
+#include <cudf/aspif.hh>
 #include "catch.hpp"
 
 //////////////////// Helpers //////////////////////////////////// {{{1
 
+// the options of the tests have all preprocessing steps disabled
+inline DependencyOptions testOptions() {
+    DependencyOptions opts;
+    opts.verbose   = false;
+    opts.dominance = false;
+    opts.probing   = false;
+    return opts;
+}
+
 struct TestDep {
-    TestDep(Criteria::CritVec crits, std::string const &in)
+    TestDep(Criteria::CritVec crits, std::string const &in, DependencyOptions const &opts = testOptions())
         : crits(crits)
-        , dep(this->crits, false, false)
+        , dep(this->crits, opts)
         , parser(dep) {
         std::stringstream sin;
         sin.str(in);
@@ -44,11 +55,89 @@ struct TestDep {
     bool contains(std::string const &name, unsigned version) {
         return dep.test_contains(name, version);
     }
+    bool fixed(std::string const &name, unsigned version) {
+        return dep.test_fixed(name, version);
+    }
+    bool removed(std::string const &name, unsigned version) {
+        return dep.test_removed(name, version);
+    }
+    unsigned depends(std::string const &name, unsigned version) {
+        return dep.test_depends(name, version);
+    }
+    bool condensed(std::string const &a, unsigned va, std::string const &b, unsigned vb) {
+        return dep.test_condensed(a, va, b, vb);
+    }
+    bool symmetric(std::string const &name, unsigned a, unsigned b) {
+        return dep.test_symmetric(name, a, b);
+    }
+    // the facts after computing conflicts
+    std::vector<std::string> facts() {
+        std::ostringstream out;
+        dep.conflicts();
+        dep.dumpAsFacts(out);
+        std::vector<std::string> ret;
+        std::istringstream in(out.str());
+        for (std::string line; std::getline(in, line); ) { ret.push_back(line); }
+        return ret;
+    }
+    // the ground program after computing conflicts
+    std::vector<std::string> aspif(bool changes = false) {
+        std::ostringstream out;
+        dep.conflicts();
+        {
+            FactWriter writer(out, nullptr);
+            AspifWriter prg(writer);
+            dep.dumpProgram(prg, changes);
+        }
+        std::vector<std::string> ret;
+        std::istringstream in(out.str());
+        for (std::string line; std::getline(in, line); ) { ret.push_back(line); }
+        return ret;
+    }
     Criteria::CritVec crits;
     Dependency dep;
     Parser parser;
 };
 
+struct TestBroken {
+    TestBroken(std::string const &in, unsigned threads = 1)
+        : dep(crits, options(threads))
+        , parser(dep) {
+        std::stringstream sin;
+        sin.str(in);
+        parser.parse(sin);
+        packages = dep.broken();
+    }
+    bool broken(std::string const &name, unsigned version) {
+        for (Package *pkg : packages) {
+            if (dep.string(pkg->name) == name && pkg->version == static_cast<int32_t>(version)) { return true; }
+        }
+        return false;
+    }
+    static DependencyOptions options(unsigned threads) {
+        DependencyOptions opts = testOptions();
+        opts.probing = true;
+        opts.threads = threads;
+        return opts;
+    }
+    Criteria::CritVec crits;
+    Dependency dep;
+    Parser parser;
+    PackageList packages;
+};
+
+// whether the given facts (or lines) contain the given one
+inline bool contains(std::vector<std::string> const &facts, std::string const &fact) {
+    return std::find(facts.begin(), facts.end(), fact) != facts.end();
+}
+
+// the number of facts (or lines) starting with the given prefix
+inline size_t count(std::vector<std::string> const &facts, std::string const &prefix) {
+    return std::count_if(facts.begin(), facts.end(), [&](std::string const &fact) {
+        return fact.compare(0, prefix.size(), prefix) == 0;
+    });
+}
+
 inline Criteria::CritVec createCrits(bool maximize, Criterion::Measurement m, Criterion::Selector f, char const *attr1 = 0, char const *attr2 = 0) {
     Criteria::CritVec crits;
     crits.push_back(Criterion());
@@ -0,0 +1,87 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+
+#include "helpers.hh"
+#include <algorithm>
+
+//////////////////// Order ////////////////////////////////////// {{{1
+
+namespace {
+
+// the facts with the given prefix
+std::vector<std::string> select(std::vector<std::string> const &facts, std::string const &prefix) {
+    std::vector<std::string> ret;
+    for (auto &fact : facts) {
+        if (fact.compare(0, prefix.size(), prefix) == 0) { ret.emplace_back(fact); }
+    }
+    return ret;
+}
+
+}
+
+TEST_CASE("order", "[order]") {
+    // the request reaches c, then a and b (in lexicographic order), and
+    // then d; e is not reachable
+    std::vector<std::string> packages = {
+        "package: e\nversion: 1\n",
+        "package: d\nversion: 1\n",
+        "package: b\nversion: 2\ndepends: d\n",
+        "package: a\nversion: 1\n",
+        "package: c\nversion: 2\ndepends: b | a\n",
+        "package: b\nversion: 1\n",
+        "package: c\nversion: 1\ndepends: a\n"};
+    auto universe = [&]() {
+        std::string ret;
+        for (auto &pkg : packages) { ret += pkg + "\n"; }
+        return ret + "request: \ninstall: c\n";
+    };
+
+    SECTION("test_canonical") {
+        auto facts = TestDep({}, universe()).facts();
+        REQUIRE(select(facts, "unit(") == std::vector<std::string>({
+            "unit(\"c\",1,in).",
+            "unit(\"c\",2,in).",
+            "unit(\"a\",1,in).",
+            "unit(\"b\",1,in).",
+            "unit(\"b\",2,in).",
+            "unit(\"d\",1,in)."}));
+        // the order of the packages in the input does not matter
+        std::reverse(packages.begin(), packages.end());
+        REQUIRE(TestDep({}, universe()).facts() == facts);
+        std::rotate(packages.begin(), packages.begin() + 3, packages.end());
+        REQUIRE(TestDep({}, universe()).facts() == facts);
+    }
+
+    SECTION("test_shuffle") {
+        auto facts = TestDep({}, universe()).facts();
+        DependencyOptions opts = testOptions();
+        opts.shuffle = 42;
+        auto shuffled = TestDep({}, universe(), opts).facts();
+        REQUIRE(TestDep({}, universe(), opts).facts() == shuffled);
+        auto units = select(facts, "unit("), shuffledUnits = select(shuffled, "unit(");
+        REQUIRE(std::is_permutation(units.begin(), units.end(), shuffledUnits.begin(), shuffledUnits.end()));
+        REQUIRE(shuffled.size() == facts.size());
+    }
+}
@@ -0,0 +1,77 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+
+#include "helpers.hh"
+
+//////////////////// Parallel /////////////////////////////////// {{{1
+
+TEST_CASE("parallel", "[parallel]") {
+    // versions of packages p1, ..., p8 depending on and conflicting with
+    // neighboring packages and recommending each other
+    std::string universe =
+        "preamble: \n"
+        "property: recommends: vpkgformula = [true!], weight: int = [0]\n"
+        "\n";
+    for (int i = 1; i <= 8; ++i) {
+        for (int v = 1; v <= 3; ++v) {
+            universe += "package: p" + std::to_string(i) + "\n";
+            universe += "version: " + std::to_string(v) + "\n";
+            if (i < 8) { universe += "depends: p" + std::to_string(i + 1) + " >= " + std::to_string(v) + "\n"; }
+            if (i > 1) { universe += "conflicts: p" + std::to_string(i - 1) + " < " + std::to_string(v) + "\n"; }
+            universe += "recommends: p" + std::to_string(9 - i) + " | p" + std::to_string(i % 8 + 1) + "\n";
+            universe += "weight: " + std::to_string(i * v) + "\n";
+            if (v == 1) { universe += "installed: true\n"; }
+            universe += "\n";
+        }
+    }
+    universe += "request: \ninstall: p1\nupgrade: p4\n";
+    Criteria::CritVec crits;
+    for (auto crit : {
+        createCrits(false, Criterion::COUNT, Criterion::REMOVED),
+        createCrits(false, Criterion::NOTUPTODATE, Criterion::SOLUTION),
+        createCrits(false, Criterion::UNSAT_RECOMMENDS, Criterion::SOLUTION),
+        createCrits(false, Criterion::SUM, Criterion::SOLUTION, "weight") }) {
+        crits.push_back(crit.front());
+    }
+
+    DependencyOptions opts = testOptions();
+
+    SECTION("test_facts") {
+        // the facts do not depend on the number of threads
+        auto facts = TestDep(crits, universe, opts).facts();
+        REQUIRE(facts.size() > 100);
+        for (unsigned threads : {3, 64}) {
+            opts.threads = threads;
+            REQUIRE(TestDep(crits, universe, opts).facts() == facts);
+        }
+    }
+
+    SECTION("test_precompute") {
+        opts.precompute = true;
+        auto facts = TestDep(crits, universe, opts).facts();
+        opts.threads = 5;
+        REQUIRE(TestDep(crits, universe, opts).facts() == facts);
+    }
+}
@@ -0,0 +1,248 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+
+
+#include "helpers.hh"
+
+//////////////////// Precompute ///////////////////////////////// {{{1
+
+TEST_CASE("precompute", "[precompute]") {
+    DependencyOptions opts = testOptions();
+    opts.precompute = true;
+    // the three versions of a form a clique; all of them depend on b and
+    // satisfy the install request, versions 1 and 2 depend on c and satisfy
+    // the dependency of d, and each pair of versions satisfies the conflict
+    // clause of the third version
+    std::string universe =
+        "package: a\n"
+        "version: 1\n"
+        "depends: b, c\n"
+        "conflicts: a\n"
+        "\n"
+        "package: a\n"
+        "version: 2\n"
+        "depends: b, c\n"
+        "conflicts: a\n"
+        "\n"
+        "package: a\n"
+        "version: 3\n"
+        "depends: b\n"
+        "conflicts: a\n"
+        "\n"
+        "package: b\n"
+        "version: 1\n"
+        "\n"
+        "package: c\n"
+        "version: 1\n"
+        "\n"
+        "package: d\n"
+        "version: 1\n"
+        "depends: a < 3\n"
+        "\n"
+        "request: \n"
+        "install: a, d\n";
+
+    SECTION("test_clique_relations") {
+        TestDep d(Criteria::CritVec(), universe, opts);
+        auto facts = d.facts();
+        REQUIRE(count(facts, "clique(") == 3);
+        // relations shared by the same versions are grouped
+        REQUIRE(count(facts, "joinClique(") == 4);
+        REQUIRE(count(facts, "relaClique(") == 9);
+        REQUIRE(count(facts, "mapsClique(") == 6);
+        REQUIRE(contains(facts, "joinClique(0,dep,1,3)."));
+        REQUIRE(contains(facts, "relaClique(0,\"a\",3,dep,1)."));
+        REQUIRE(contains(facts, "mapsClique(0,dep,1,sat,6)."));
+        REQUIRE(contains(facts, "joinClique(0,dep,2,2)."));
+        REQUIRE(contains(facts, "mapsClique(0,dep,2,sat,5)."));
+        REQUIRE(!contains(facts, "relaClique(0,\"a\",3,dep,2)."));
+    }
+
+    SECTION("test_disabled") {
+        TestDep d(Criteria::CritVec(), universe);
+        auto facts = d.facts();
+        REQUIRE(count(facts, "clique(") == 3);
+        REQUIRE(count(facts, "joinClique(") == 0);
+        REQUIRE(count(facts, "relaClique(") == 0);
+        REQUIRE(count(facts, "mapsClique(") == 0);
+    }
+
+    SECTION("test_objectives") {
+        Criteria::CritVec crits;
+        for (auto crit : {
+            createCrits(false, Criterion::COUNT, Criterion::REMOVED),
+            createCrits(false, Criterion::COUNT, Criterion::CHANGED),
+            createCrits(false, Criterion::NOTUPTODATE, Criterion::SOLUTION),
+            createCrits(true, Criterion::COUNT, Criterion::UP) }) {
+            crits.push_back(crit.front());
+        }
+        TestDep d(crits,
+            "package: a\n"
+            "version: 1\n"
+            "installed: true\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "installed: true\n"
+            "conflicts: a\n"
+            "\n"
+            "package: c\n"
+            "version: 1\n"
+            "depends: a\n"
+            "\n"
+            "package: d\n"
+            "version: 1\n"
+            "installed: true\n"
+            "\n"
+            "request: \n"
+            "install: c\n"
+            "remove: d\n", opts);
+        auto facts = d.facts();
+        REQUIRE(contains(facts, "target(sol,up,\"a\",2)."));
+        REQUIRE(contains(facts, "object(count,sol,up,\"a\",2,1)."));
+        REQUIRE(contains(facts, "object(notuptodate,sol,solution,\"a\",1,1)."));
+        REQUIRE(!contains(facts, "object(notuptodate,sol,solution,\"a\",2,1)."));
+        REQUIRE(contains(facts, "object(count,sol,changed,\"c\",1,1)."));
+        REQUIRE(contains(facts, "object(count,sub,changed,\"b\",1,1)."));
+        // d cannot be installed
+        REQUIRE(contains(facts, "delete(changed,\"d\",1)."));
+        REQUIRE(contains(facts, "delete(removed,\"d\",1)."));
+        REQUIRE(count(facts, "object(count,sub,changed,\"d\"") == 0);
+        REQUIRE(count(facts, "remove(") == 2);
+        REQUIRE(contains(facts, "remove(count,\"a\",1)."));
+        REQUIRE(count(facts, "object(") == 6);
+    }
+
+    SECTION("test_aligned") {
+        // a has to be upgraded, which removes b; c cannot be installed; the
+        // remaining version of d forms a clique with its installed version
+        std::string universe =
+            "preamble: \n"
+            "property: src: int = [0], ver: int = [0]\n"
+            "\n"
+            "package: a\n"
+            "version: 1\n"
+            "installed: true\n"
+            "src: 1\n"
+            "ver: 1\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "conflicts: b\n"
+            "src: 1\n"
+            "ver: 2\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "installed: true\n"
+            "src: 1\n"
+            "ver: 3\n"
+            "\n"
+            "package: c\n"
+            "version: 1\n"
+            "installed: true\n"
+            "depends: z\n"
+            "src: 1\n"
+            "ver: 4\n"
+            "\n"
+            "package: d\n"
+            "version: 1\n"
+            "installed: true\n"
+            "src: 2\n"
+            "ver: 1\n"
+            "\n"
+            "package: d\n"
+            "version: 2\n"
+            "src: 2\n"
+            "ver: 5\n"
+            "\n"
+            "request: \n"
+            "install: a = 2\n";
+        SECTION("changed") {
+            TestDep d(createCrits(false, Criterion::ALIGNED, Criterion::CHANGED, "src", "ver"), universe, opts);
+            auto facts = d.facts();
+            // the values of the deleted packages b and c are static
+            REQUIRE(contains(facts, "object(aligned(\"src\",1,\"ver\",1),sub,changed,\"a\",1)."));
+            REQUIRE(contains(facts, "object(aligned(\"src\",1,\"ver\",2),sol,changed,\"a\",2)."));
+            REQUIRE(count(facts, "object(") == 2);
+            REQUIRE(contains(facts, "statkey(changed,\"src\",1,\"ver\")."));
+            REQUIRE(contains(facts, "alcount(changed,\"src\",1,\"ver\")."));
+            REQUIRE(contains(facts, "alchain(changed,\"src\",1,\"ver\",1,2)."));
+            REQUIRE(contains(facts, "alchain(changed,\"src\",1,\"ver\",2)."));
+            REQUIRE(count(facts, "alchain(") == 2);
+        }
+        SECTION("removed") {
+            TestDep d(createCrits(false, Criterion::ALIGNED, Criterion::REMOVED, "src", "ver"), universe, opts);
+            auto facts = d.facts();
+            REQUIRE(contains(facts, "remove(aligned(\"src\",1,\"ver\",1),\"a\")."));
+            REQUIRE(count(facts, "remove(") == 1);
+            REQUIRE(contains(facts, "statkey(removed,\"src\",1,\"ver\")."));
+            REQUIRE(contains(facts, "alchain(removed,\"src\",1,\"ver\",1)."));
+        }
+        SECTION("solution") {
+            // the only key with two values has both of them in one clique
+            TestDep d(createCrits(false, Criterion::ALIGNED, Criterion::SOLUTION, "src", "ver"), universe, opts);
+            auto facts = d.facts();
+            REQUIRE(count(facts, "object(") == 0);
+            REQUIRE(count(facts, "alcount(") == 0);
+        }
+    }
+
+    SECTION("test_bounds") {
+        Criteria::CritVec crits;
+        for (auto crit : {
+            createCrits(false, Criterion::COUNT, Criterion::REMOVED),
+            createCrits(false, Criterion::COUNT, Criterion::CHANGED),
+            createCrits(false, Criterion::COUNT, Criterion::NEW),
+            createCrits(false, Criterion::NOTUPTODATE, Criterion::SOLUTION) }) {
+            crits.push_back(crit.front());
+        }
+        // only one of the conflicting installed packages a and b can be
+        // kept and c has to be installed
+        TestDep d(crits,
+            "package: a\n"
+            "version: 1\n"
+            "installed: true\n"
+            "conflicts: b\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "installed: true\n"
+            "\n"
+            "package: c\n"
+            "version: 1\n"
+            "\n"
+            "request: \n"
+            "install: c\n", opts);
+        auto facts = d.facts();
+        REQUIRE(contains(facts, "lowerbound(removed,count,1)."));
+        REQUIRE(contains(facts, "lowerbound(changed,count,2)."));
+        REQUIRE(contains(facts, "lowerbound(new,count,1)."));
+        REQUIRE(count(facts, "lowerbound(") == 3);
+    }
+}
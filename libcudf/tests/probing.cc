@@ -0,0 +1,111 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+
+
+#include "helpers.hh"
+
+//////////////////// Probing //////////////////////////////////// {{{1
+
+TEST_CASE("probing", "[probing]") {
+    DependencyOptions opts = testOptions();
+    opts.probing = true;
+    // a = 1 needs b and c, which are in conflict
+    std::string universe =
+        "package: a\n"
+        "version: 1\n"
+        "depends: b, c\n"
+        "\n"
+        "package: a\n"
+        "version: 2\n"
+        "depends: b\n"
+        "\n"
+        "package: b\n"
+        "version: 1\n"
+        "conflicts: c\n"
+        "\n"
+        "package: c\n"
+        "version: 1\n"
+        "\n"
+        "package: d\n"
+        "version: 1\n"
+        "depends: a = 1\n"
+        "\n"
+        "package: e\n"
+        "version: 1\n"
+        "depends: d | c\n"
+        "\n";
+
+    SECTION("test_prune") {
+        for (unsigned threads : {1, 3}) {
+            opts.threads = threads;
+            TestDep d(Criteria::CritVec(), universe +
+                "request: \n"
+                "install: e\n", opts);
+            REQUIRE( d.removed("a", 1));
+            REQUIRE( d.removed("d", 1));
+            REQUIRE( d.fixed("c", 1));
+            REQUIRE( d.removed("b", 1));
+            REQUIRE( d.removed("a", 2));
+            REQUIRE(!d.contains("d", 1));
+        }
+    }
+
+    SECTION("test_no_probing") {
+        TestDep d(Criteria::CritVec(), universe +
+            "request: \n"
+            "install: e\n");
+        REQUIRE(!d.removed("a", 1));
+        REQUIRE(!d.removed("d", 1));
+        REQUIRE( d.contains("d", 1));
+    }
+
+    SECTION("test_request") {
+        // installing b rules out c, so e can only be installed with d
+        TestDep d(Criteria::CritVec(), universe +
+            "request: \n"
+            "install: b\n", opts);
+        REQUIRE( d.removed("c", 1));
+        REQUIRE( d.removed("e", 1));
+        REQUIRE(!d.removed("a", 2));
+    }
+
+    SECTION("test_broken") {
+        for (unsigned threads : {1, 2, 8}) {
+            TestBroken d(universe +
+                "package: f\n"
+                "version: 1\n"
+                "depends: g\n"
+                "\n"
+                "request: \n"
+                "install: b\n", threads);
+            REQUIRE(d.packages.size() == 3);
+            REQUIRE( d.broken("a", 1));
+            REQUIRE( d.broken("d", 1));
+            REQUIRE( d.broken("f", 1));
+            REQUIRE(!d.broken("c", 1));
+            REQUIRE(!d.broken("e", 1));
+        }
+    }
+}
@@ -0,0 +1,149 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+
+
+#include "helpers.hh"
+
+//////////////////// Propagate ////////////////////////////////// {{{1
+
+TEST_CASE("propagate", "[propagate]") {
+    SECTION("test_single_candidate") {
+        TestDep d(Criteria::CritVec(),
+            "package: a\n"
+            "version: 1\n"
+            "depends: b\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "conflicts: c\n"
+            "\n"
+            "package: c\n"
+            "version: 1\n"
+            "\n"
+            "package: d\n"
+            "version: 1\n"
+            "depends: c | b\n"
+            "\n"
+            "request: \n"
+            "install: a\n"
+        );
+        REQUIRE( d.fixed("a", 1));
+        REQUIRE( d.fixed("b", 1));
+        REQUIRE( d.removed("c", 1));
+        REQUIRE(!d.fixed("d", 1));
+        REQUIRE(!d.removed("d", 1));
+    }
+
+    SECTION("test_keep_version") {
+        TestDep d(Criteria::CritVec(),
+            "package: a\n"
+            "version: 1\n"
+            "installed: true\n"
+            "keep: version\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "conflicts: a = 1\n"
+            "\n"
+            "request: \n"
+        );
+        REQUIRE( d.fixed("a", 1));
+        REQUIRE(!d.fixed("a", 2));
+        REQUIRE( d.removed("b", 1));
+    }
+
+    SECTION("test_empty_depends") {
+        TestDep d(Criteria::CritVec(),
+            "package: a\n"
+            "version: 1\n"
+            "depends: b\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "depends: c\n"
+            "\n"
+            "package: c\n"
+            "version: 1\n"
+            "\n"
+            "package: e\n"
+            "version: 1\n"
+            "depends: a | c\n"
+            "\n"
+            "request: \n"
+            "remove: c\n"
+        );
+        REQUIRE( d.removed("a", 1));
+        REQUIRE( d.removed("b", 1));
+        REQUIRE( d.removed("c", 1));
+        REQUIRE( d.removed("e", 1));
+    }
+
+    SECTION("test_unsatisfiable") {
+        TestDep d(Criteria::CritVec(),
+            "package: a\n"
+            "version: 1\n"
+            "depends: b\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "\n"
+            "package: c\n"
+            "version: 1\n"
+            "\n"
+            "request: \n"
+            "install: a, c\n"
+            "remove: b\n"
+        );
+        REQUIRE(!d.fixed("a", 1));
+        REQUIRE(!d.fixed("c", 1));
+        REQUIRE(!d.removed("a", 1));
+        REQUIRE(!d.removed("c", 1));
+    }
+
+    SECTION("test_upgrade") {
+        TestDep d(Criteria::CritVec(),
+            "package: a\n"
+            "version: 1\n"
+            "installed: true\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "depends: c\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "conflicts: a\n"
+            "\n"
+            "request: \n"
+            "upgrade: a\n"
+        );
+        REQUIRE( d.fixed("a", 1));
+        REQUIRE( d.removed("a", 2));
+        REQUIRE( d.removed("b", 1));
+    }
+}
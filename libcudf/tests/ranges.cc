@@ -0,0 +1,111 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+
+#include "helpers.hh"
+#include <algorithm>
+
+//////////////////// Ranges ///////////////////////////////////// {{{1
+
+namespace {
+
+// the satisfies facts without their condition
+std::vector<std::string> satisfies(std::vector<std::string> const &facts) {
+    std::vector<std::string> ret;
+    for (auto &fact : facts) {
+        if (fact.compare(0, 10, "satisfies(") == 0) { ret.emplace_back(fact.substr(0, fact.rfind(','))); }
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+}
+
+TEST_CASE("ranges", "[ranges]") {
+    // version 4 of a is not installable and does not interrupt ranges
+    std::string universe =
+        "package: a\n"
+        "version: 1\n"
+        "\n"
+        "package: a\n"
+        "version: 2\n"
+        "\n"
+        "package: a\n"
+        "version: 3\n"
+        "\n"
+        "package: a\n"
+        "version: 4\n"
+        "depends: z\n"
+        "\n"
+        "package: a\n"
+        "version: 5\n"
+        "\n"
+        "package: b\n"
+        "version: 1\n"
+        "depends: a >= 2\n"
+        "\n"
+        "package: c\n"
+        "version: 1\n"
+        "depends: a != 2\n"
+        "\n"
+        "package: d\n"
+        "version: 1\n"
+        "depends: a = 1 | a = 5\n"
+        "\n"
+        "request: \n"
+        "install: b, c, d\n";
+
+    DependencyOptions opts = testOptions();
+    opts.probing = true;
+
+    SECTION("test_versions") {
+        TestDep td({}, universe, opts);
+        REQUIRE(satisfies(td.facts()) == std::vector<std::string>({
+            "satisfies(\"a\",1",
+            "satisfies(\"a\",1",
+            "satisfies(\"a\",2",
+            "satisfies(\"a\",3",
+            "satisfies(\"a\",3",
+            "satisfies(\"a\",5",
+            "satisfies(\"a\",5",
+            "satisfies(\"a\",5",
+            "satisfies(\"b\",1",
+            "satisfies(\"c\",1",
+            "satisfies(\"d\",1"}));
+    }
+
+    SECTION("test_ranges") {
+        opts.ranges = true;
+        TestDep td({}, universe, opts);
+        REQUIRE(satisfies(td.facts()) == std::vector<std::string>({
+            "satisfies(\"a\",1",
+            "satisfies(\"a\",1",
+            "satisfies(\"a\",2,5",
+            "satisfies(\"a\",3,5",
+            "satisfies(\"a\",5",
+            "satisfies(\"b\",1",
+            "satisfies(\"c\",1",
+            "satisfies(\"d\",1"}));
+    }
+}
@@ -0,0 +1,82 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+#include "helpers.hh"
+
+//////////////////// Scaling //////////////////////////////////// {{{1
+
+TEST_CASE("scaling", "[scaling]") {
+    std::string universe =
+        "preamble: \n"
+        "property: size: int = [0], group: int = [0]\n"
+        "\n"
+        "package: a\n"
+        "version: 1\n"
+        "size: 300\n"
+        "group: 6\n"
+        "\n"
+        "package: b\n"
+        "version: 1\n"
+        "size: -200\n"
+        "group: 4\n"
+        "\n"
+        "package: c\n"
+        "version: 1\n"
+        "\n"
+        "request: \n"
+        "install: a, b, c\n";
+
+    SECTION("test_sum") {
+        Criteria::CritVec crits;
+        for (auto crit : {
+            createCrits(false, Criterion::COUNT, Criterion::REMOVED),
+            createCrits(false, Criterion::SUM, Criterion::SOLUTION, "size") }) {
+            crits.push_back(crit.front());
+        }
+        TestDep d(crits, universe);
+        auto facts = d.facts();
+        REQUIRE(d.dep.scale(d.dep.index("size")) == 100);
+        REQUIRE(contains(facts, "attribute(\"a\",1,\"size\",3)."));
+        REQUIRE(contains(facts, "attribute(\"b\",1,\"size\",-2)."));
+        // zero weights are dropped
+        REQUIRE(count(facts, "attribute(\"c\",1,") == 0);
+        REQUIRE(contains(facts, "scale(1,100)."));
+    }
+
+    SECTION("test_aligned") {
+        // attributes of aligned criteria keep their values
+        Criteria::CritVec crits;
+        for (auto crit : {
+            createCrits(false, Criterion::SUM, Criterion::SOLUTION, "group"),
+            createCrits(false, Criterion::ALIGNED, Criterion::SOLUTION, "size", "group") }) {
+            crits.push_back(crit.front());
+        }
+        TestDep d(crits, universe);
+        auto facts = d.facts();
+        REQUIRE(d.dep.scale(d.dep.index("group")) == 0);
+        REQUIRE(contains(facts, "attribute(\"a\",1,\"group\",6)."));
+        REQUIRE(contains(facts, "attribute(\"c\",1,\"size\",0)."));
+        REQUIRE(count(facts, "scale(") == 0);
+    }
+}
@@ -0,0 +1,105 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+
+
+#include "helpers.hh"
+
+//////////////////// Subsumption //////////////////////////////// {{{1
+
+TEST_CASE("subsumption", "[subsumption]") {
+    SECTION("test_local") {
+        TestDep d(Criteria::CritVec(),
+            "package: a\n"
+            "version: 1\n"
+            "depends: b, b | c, c | d | b, c | d, d | c\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "\n"
+            "package: c\n"
+            "version: 1\n"
+            "\n"
+            "package: d\n"
+            "version: 1\n"
+            "\n"
+            "request: \n"
+            "install: a\n"
+        );
+        REQUIRE(d.depends("a", 1) == 2);
+    }
+
+    SECTION("test_forced") {
+        TestDep d(Criteria::CritVec(),
+            "package: a\n"
+            "version: 1\n"
+            "depends: b, c | e, a | d, d | e | f\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "depends: c\n"
+            "\n"
+            "package: c\n"
+            "version: 1\n"
+            "depends: d | e\n"
+            "\n"
+            "package: d\n"
+            "version: 1\n"
+            "\n"
+            "package: e\n"
+            "version: 1\n"
+            "\n"
+            "package: f\n"
+            "version: 1\n"
+            "\n"
+            "request: \n"
+            "install: a\n"
+        );
+        REQUIRE(d.depends("a", 1) == 1);
+        REQUIRE(d.depends("b", 1) == 1);
+        REQUIRE(d.depends("c", 1) == 1);
+    }
+
+    SECTION("test_cycle") {
+        TestDep d(Criteria::CritVec(),
+            "package: a\n"
+            "version: 1\n"
+            "depends: b, c | d\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "depends: a, c | d\n"
+            "\n"
+            "package: c\n"
+            "version: 1\n"
+            "\n"
+            "package: d\n"
+            "version: 1\n"
+            "\n"
+            "request: \n"
+            "install: a\n"
+        );
+        REQUIRE(d.depends("a", 1) + d.depends("b", 1) == 3);
+    }
+}
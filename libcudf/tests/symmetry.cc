@@ -0,0 +1,121 @@
+// {{{ MIT License
+
+// Copyright 2017 Roland Kaminski
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// }}}
+//////////////////// Preamble /////////////////////////////////// {{{1
+
+
+#include "helpers.hh"
+
+//////////////////// Symmetry /////////////////////////////////// {{{1
+
+TEST_CASE("symmetry", "[symmetry]") {
+    SECTION("test_rebuilds") {
+        TestDep d(Criteria::CritVec(),
+            "package: a\n"
+            "version: 1\n"
+            "depends: c\n"
+            "conflicts: a\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "depends: c\n"
+            "conflicts: a\n"
+            "\n"
+            "package: a\n"
+            "version: 3\n"
+            "depends: c\n"
+            "conflicts: a\n"
+            "\n"
+            "package: a\n"
+            "version: 4\n"
+            "conflicts: a\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "depends: a | d\n"
+            "\n"
+            "package: c\n"
+            "version: 1\n"
+            "\n"
+            "package: d\n"
+            "version: 1\n"
+            "\n"
+            "request: \n"
+            "install: b\n"
+        );
+        d.dep.conflicts();
+        d.dep.symmetries();
+        REQUIRE( d.symmetric("a", 1, 2));
+        REQUIRE( d.symmetric("a", 2, 3));
+        REQUIRE(!d.symmetric("a", 3, 4));
+    }
+
+    SECTION("test_asymmetric") {
+        TestDep d(createCrits(false, Criterion::COUNT, Criterion::CHANGED),
+            "package: a\n"
+            "version: 1\n"
+            "installed: true\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "\n"
+            "package: a\n"
+            "version: 3\n"
+            "\n"
+            "package: a\n"
+            "version: 4\n"
+            "\n"
+            "package: b\n"
+            "version: 1\n"
+            "depends: a | c\n"
+            "\n"
+            "package: c\n"
+            "version: 1\n"
+            "depends: a >= 3\n"
+            "\n"
+            "request: \n"
+            "install: b\n"
+        );
+        d.dep.conflicts();
+        d.dep.symmetries();
+        REQUIRE(!d.symmetric("a", 1, 2));
+        REQUIRE(!d.symmetric("a", 2, 3));
+        REQUIRE( d.symmetric("a", 3, 4));
+    }
+
+    SECTION("test_upgrade") {
+        TestDep d(Criteria::CritVec(),
+            "package: a\n"
+            "version: 1\n"
+            "\n"
+            "package: a\n"
+            "version: 2\n"
+            "\n"
+            "request: \n"
+            "upgrade: a\n"
+        );
+        d.dep.conflicts();
+        d.dep.symmetries();
+        REQUIRE(!d.symmetric("a", 1, 2));
+    }
+}
@@ -12,7 +12,7 @@ aspcud="$location/../build/debug/bin/aspcud"
 
 for x in "$location"/enumerate-all/*.cudf; do
     echo "================== $(basename $x) ================="
-    "$cudf" < "$x" 2>/dev/null | "$gringo" - "$encoding" 2>/dev/null | "$clasp" 0 --outf=1 -V0 -q0,0 | grep -v "A" |\
+    "$cudf" --no-dominance --no-symmetry < "$x" 2>/dev/null | "$gringo" - "$encoding" 2>/dev/null | "$clasp" 0 --outf=1 -V0 -q0,0 | grep -v "A" |\
     while read line; do
         if [[ -n "$line" ]]; then
             echo "$line" | tr " " "\n" | sort | tr -d "\n"
@@ -26,7 +26,11 @@ for x in "$location"/*/*.cudf.xz; do
     echo "================== $(basename $x) with $crit ================="
     xzcat "$x" > problem.cudf
     for solver in "$clasp"; do
-        for encoding in "$location/../encodings/misc2012.lp" "$location/../encodings/specification.lp"; do
+        for encoding in "$location/../encodings/misc2012.lp" "$location/../encodings/misc2012-lean.lp" "$location/../encodings/specification.lp"; do
+            extra=()
+            if [[ "$(basename "$encoding")" == misc2012-lean.lp ]]; then
+                extra=(-p --precompute)
+            fi
             start=$(date +%s)
             # echo "\"$aspcud\" -e \"$encoding\" -S \"$solver\" -G \"$gringo\" -P \"$cudf\" problem.cudf solution.cudf \"$crit\""
             "$aspcud" -e "$encoding" -S "$solver" -G "$gringo" -P "$cudf" "${extra[@]}" problem.cudf solution.cudf "$crit" > /dev/null